@@ -0,0 +1,310 @@
+// Throughput benchmarks for db2::Connection against the in-process fake CLI
+// (tests/fake_db2cli). Numbers measure the wrapper's own overhead plus
+// whatever server time is simulated with fake_db2cli::set_latency, not a
+// real DB2 server.
+//
+//   cmake -S . -B build -DDB2_USE_FAKE_CLI=ON -DBUILD_DB2_BENCHMARKS=ON
+//   cmake --build build --target db2_benchmarks
+//   ./build/db2_benchmarks --benchmark_filter=Query
+
+#include <benchmark/benchmark.h>
+
+#include <chrono>
+#include <cstdint>
+#include <exception>
+#include <memory>
+#include <string>
+#include <tuple>
+#include <vector>
+
+#include "db2/db2.hpp"
+#include "fake_db2cli.h"
+#include "resource/resource_pool.hpp"
+
+using namespace std::chrono_literals;
+
+namespace {
+
+constexpr const char* kSelect = "SELECT ID, NAME, PRICE FROM APP.ITEMS";
+constexpr const char* kSelectById = "SELECT ID, NAME, PRICE FROM APP.ITEMS WHERE ID = ?";
+constexpr const char* kUpdate = "UPDATE APP.ITEMS SET PRICE = ? WHERE ID = ?";
+
+using Item = std::tuple<int32_t, std::string, double>;
+
+fake_db2cli::ResultSet items(std::int64_t rows) {
+  fake_db2cli::ResultSet rs;
+  rs.columns = {{"ID", SQL_INTEGER, 10, 0, false}, {"NAME", SQL_VARCHAR, 32}, {"PRICE", SQL_DECIMAL, 10, 2}};
+  rs.rows.reserve(static_cast<std::size_t>(rows));
+  for (std::int64_t i = 0; i < rows; ++i) {
+    rs.rows.push_back({i, "item-" + std::to_string(i), std::to_string(i % 100) + ".25"});
+  }
+  return rs;
+}
+
+// Fresh fake server state and a connection to it. Each benchmark uses its own
+// target so circuit breakers (shared per target) do not leak between them.
+std::unique_ptr<db2::Connection> connect(const char* target) {
+  auto conn = std::make_unique<db2::Connection>();
+  conn->connect_with_conn_str(target);
+  return conn;
+}
+
+// query_as over a fixed result; range(0) = rows, range(1) = rowset size
+void BM_QueryAs(benchmark::State& state) {
+  fake_db2cli::reset();
+  fake_db2cli::set_result(kSelect, items(state.range(0)));
+  auto conn = connect("BENCH-QUERY");
+  const db2::QueryOptions options{.rowset_size = static_cast<std::size_t>(state.range(1))};
+  for (auto _ : state) {
+    auto rows = conn->query_as<Item>(kSelect, {}, options);
+    benchmark::DoNotOptimize(rows.data());
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_QueryAs)->ArgsProduct({{100, 10000}, {1, 64, 512}});
+
+// Same with simulated per-SQLFetch round trip, where block fetch pays off most
+void BM_QueryAsFetchLatency(benchmark::State& state) {
+  fake_db2cli::reset();
+  fake_db2cli::set_result(kSelect, items(1000));
+  fake_db2cli::set_latency({.fetch = 20us});
+  auto conn = connect("BENCH-QUERY-LATENCY");
+  const db2::QueryOptions options{.rowset_size = static_cast<std::size_t>(state.range(0))};
+  for (auto _ : state) {
+    auto rows = conn->query_as<Item>(kSelect, {}, options);
+    benchmark::DoNotOptimize(rows.data());
+  }
+  state.SetItemsProcessed(state.iterations() * 1000);
+}
+BENCHMARK(BM_QueryAsFetchLatency)->Arg(1)->Arg(64)->Arg(512)->UseRealTime();
+
+// Row-mapper query, row at a time vs block fetch
+void BM_QueryMapper(benchmark::State& state) {
+  fake_db2cli::reset();
+  fake_db2cli::set_result(kSelect, items(1000));
+  auto conn = connect("BENCH-MAPPER");
+  const db2::QueryOptions options{.rowset_size = static_cast<std::size_t>(state.range(0))};
+  for (auto _ : state) {
+    auto rows = conn->query<std::int64_t>(kSelect, options, [](const db2::Connection::Row& row) {
+      return row.getInt64(1).value_or(0) + static_cast<std::int64_t>(row.getStringView(2).value_or("").size());
+    });
+    benchmark::DoNotOptimize(rows.data());
+  }
+  state.SetItemsProcessed(state.iterations() * 1000);
+}
+BENCHMARK(BM_QueryMapper)->Arg(1)->Arg(256);
+
+void BM_QueryColumnar(benchmark::State& state) {
+  fake_db2cli::reset();
+  fake_db2cli::set_result(kSelect, items(10000));
+  auto conn = connect("BENCH-COLUMNAR");
+  const db2::ColumnType hints[] = {db2::ColumnType::Any, db2::ColumnType::Any, db2::ColumnType::Real};
+  for (auto _ : state) {
+    auto result = conn->query_columnar(kSelect, {}, {}, hints);
+    benchmark::DoNotOptimize(result.rows);
+  }
+  state.SetItemsProcessed(state.iterations() * 10000);
+}
+BENCHMARK(BM_QueryColumnar);
+
+// Streaming through a cursor without materializing rows
+void BM_CursorFetch(benchmark::State& state) {
+  fake_db2cli::reset();
+  fake_db2cli::set_result(kSelect, items(10000));
+  auto conn = connect("BENCH-CURSOR");
+  const db2::QueryOptions options{.rowset_size = static_cast<std::size_t>(state.range(0))};
+  for (auto _ : state) {
+    std::int64_t sum = 0;
+    auto cursor = conn->open_cursor(kSelect, {}, options);
+    while (const auto* row = cursor.next()) sum += row->getInt32(1).value_or(0);
+    benchmark::DoNotOptimize(sum);
+  }
+  state.SetItemsProcessed(state.iterations() * 10000);
+}
+BENCHMARK(BM_CursorFetch)->Arg(1)->Arg(512);
+
+// One 4 MiB CLOB per iteration, streamed in range(0)-byte chunks; 0 reads it
+// whole with getStringView for comparison
+void BM_ReadLob(benchmark::State& state) {
+  constexpr std::int64_t kLobBytes = 4 << 20;
+  fake_db2cli::reset();
+  fake_db2cli::ResultSet rs;
+  rs.columns = {{"DOC", SQL_CLOB, 1 << 30}};
+  rs.rows = {{std::string(kLobBytes, 'x')}};
+  fake_db2cli::set_result("SELECT DOC FROM APP.DOCS", rs);
+  auto conn = connect("BENCH-LOB");
+  const auto chunk = static_cast<std::size_t>(state.range(0));
+  for (auto _ : state) {
+    auto cursor = conn->open_cursor("SELECT DOC FROM APP.DOCS");
+    const auto* row = cursor.next();
+    std::size_t bytes = 0;
+    if (chunk == 0) {
+      bytes = row->getStringView(1)->size();
+    } else {
+      row->readLob(1, [&](std::string_view data) { bytes += data.size(); return true; }, chunk);
+    }
+    benchmark::DoNotOptimize(bytes);
+  }
+  state.SetBytesProcessed(state.iterations() * kLobBytes);
+}
+BENCHMARK(BM_ReadLob)->Arg(0)->Arg(4096)->Arg(64 * 1024);
+
+// Single-row lookup through the statement cache (prepare once, execute many)
+void BM_PointQuery(benchmark::State& state) {
+  fake_db2cli::reset();
+  fake_db2cli::set_handler([](std::string_view, const std::vector<fake_db2cli::Value>& params) {
+    auto rs = items(0);
+    if (!params.empty()) rs.rows.push_back({params[0], std::string("item"), std::string("1.25")});
+    return rs;
+  });
+  auto conn = connect("BENCH-POINT");
+  std::int32_t id = 0;
+  for (auto _ : state) {
+    auto rows = conn->query_as<Item>(kSelectById, {db2::Param{id++}});
+    benchmark::DoNotOptimize(rows.data());
+  }
+  state.SetItemsProcessed(state.iterations());
+  state.counters["prepares"] = static_cast<double>(fake_db2cli::stats().prepares);
+}
+BENCHMARK(BM_PointQuery);
+
+void BM_ExecutePrepared(benchmark::State& state) {
+  fake_db2cli::reset();
+  auto conn = connect("BENCH-EXECUTE");
+  std::int32_t id = 0;
+  for (auto _ : state) conn->execute(kUpdate, {db2::Param{1.5}, db2::Param{id++}});
+  state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_ExecutePrepared);
+
+void BM_ExecuteDirect(benchmark::State& state) {
+  fake_db2cli::reset();
+  auto conn = connect("BENCH-EXECUTE-DIRECT");
+  for (auto _ : state) conn->execute("UPDATE APP.ITEMS SET PRICE = PRICE * 1.01");
+  state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_ExecuteDirect);
+
+// 10000 rows per iteration; range(0) = parameter sets per SQLExecute, with
+// simulated per-execute round trip
+void BM_ExecuteBatch(benchmark::State& state) {
+  fake_db2cli::reset();
+  fake_db2cli::set_latency({.execute = 50us});
+  auto conn = connect("BENCH-BATCH");
+  std::vector<std::vector<db2::Param>> rows;
+  rows.reserve(10000);
+  for (std::int32_t i = 0; i < 10000; ++i) rows.push_back({db2::Param{i * 0.5}, db2::Param{i}});
+  const db2::BatchOptions options{.chunk_size = static_cast<std::size_t>(state.range(0))};
+  for (auto _ : state) {
+    auto result = conn->execute_batch(kUpdate, rows, options);
+    benchmark::DoNotOptimize(result.rows_affected);
+  }
+  state.SetItemsProcessed(state.iterations() * 10000);
+}
+BENCHMARK(BM_ExecuteBatch)->Arg(100)->Arg(1000)->Arg(10000)->UseRealTime();
+
+// Acquire + point query from a shared pool; simulated server time lets
+// threads overlap as they would against a real server
+void BM_PoolPointQuery(benchmark::State& state) {
+  static const auto pool = resource::ResourcePool<db2::Connection>::create(8, [] {
+    return connect("BENCH-POOL");
+  });
+  if (state.thread_index() == 0) {
+    fake_db2cli::reset();
+    fake_db2cli::set_result(kSelectById, items(1));
+    fake_db2cli::set_latency({.execute = 100us});
+  }
+  for (auto _ : state) {
+    auto conn = pool->acquire();
+    auto rows = conn->query_as<Item>(kSelectById, {db2::Param{std::int32_t{0}}});
+    benchmark::DoNotOptimize(rows.data());
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_PoolPointQuery)->ThreadRange(1, 16)->UseRealTime();
+
+// Bare checkout/return of a pooled connection: range(0) = 0 for the
+// shared_ptr handle from acquire(), 1 for the allocation-free PooledRef
+void BM_PoolAcquireRelease(benchmark::State& state) {
+  fake_db2cli::reset();
+  const auto pool = resource::ResourcePool<db2::Connection>::create(1, [] {
+    return connect("BENCH-CHECKOUT");
+  }, {}, /*warmup_size=*/1);
+  const bool ref = state.range(0) == 1;
+  for (auto _ : state) {
+    if (ref) {
+      auto conn = pool->acquire_ref();
+      benchmark::DoNotOptimize(conn.get());
+    } else {
+      auto conn = pool->acquire();
+      benchmark::DoNotOptimize(conn.get());
+    }
+  }
+  state.SetItemsProcessed(state.iterations());
+  state.SetLabel(ref ? "PooledRef" : "shared_ptr");
+}
+BENCHMARK(BM_PoolAcquireRelease)->Arg(0)->Arg(1);
+
+// Checkout/return from many threads at once: range(0) = idle-list shards
+// (1 = the single shared list)
+void BM_PoolAcquireContended(benchmark::State& state) {
+  static std::shared_ptr<resource::ResourcePool<db2::Connection>> pool;
+  if (state.thread_index() == 0) {
+    fake_db2cli::reset();
+    pool = resource::ResourcePool<db2::Connection>::create(16, [] {
+      return connect("BENCH-CONTENDED");
+    }, {}, /*warmup_size=*/16, static_cast<std::size_t>(state.range(0)));
+  }
+  for (auto _ : state) {
+    auto conn = pool->acquire_ref();
+    benchmark::DoNotOptimize(conn.get());
+  }
+  state.SetItemsProcessed(state.iterations());
+  if (state.thread_index() == 0) pool.reset();
+}
+BENCHMARK(BM_PoolAcquireContended)->Arg(1)->Arg(8)->ThreadRange(1, 16)->UseRealTime();
+
+// Cost of recovering from a dropped link: the next call fails with 08S01,
+// reconnects and retries. range(0) = simulated connect time in microseconds.
+void BM_ReconnectAfterDrop(benchmark::State& state) {
+  fake_db2cli::reset();
+  fake_db2cli::set_latency({.connect = std::chrono::microseconds(state.range(0))});
+  auto conn = connect("BENCH-RECONNECT");
+  std::int32_t id = 0;
+  for (auto _ : state) {
+    fake_db2cli::drop_connections();
+    conn->execute(kUpdate, {db2::Param{1.5}, db2::Param{id++}});
+  }
+  state.SetItemsProcessed(state.iterations());
+  state.counters["reconnects"] = static_cast<double>(fake_db2cli::stats().connects - 1);
+}
+BENCHMARK(BM_ReconnectAfterDrop)->Arg(0)->Arg(1000)->UseRealTime();
+
+// While the server is unreachable and the breaker is open, calls must fail
+// without attempting to connect
+void BM_BreakerOpenFailFast(benchmark::State& state) {
+  fake_db2cli::reset();
+  auto conn = connect("BENCH-BREAKER");
+  conn->set_circuit_breaker(std::make_shared<db2::CircuitBreaker>(
+      db2::CircuitBreaker::Options{.initial_backoff = 1h, .max_backoff = 1h}));
+  fake_db2cli::set_latency({.connect = 1ms});
+  fake_db2cli::fail_connects(1 << 30);
+  fake_db2cli::drop_connections();
+  std::int64_t failures = 0;
+  for (auto _ : state) {
+    try {
+      conn->execute(kUpdate, {db2::Param{1.5}, db2::Param{std::int32_t{1}}});
+    } catch (const std::exception&) {
+      ++failures;
+    }
+  }
+  state.SetItemsProcessed(state.iterations());
+  state.counters["connect_attempts"] = static_cast<double>(fake_db2cli::stats().connect_failures);
+  if (failures != static_cast<std::int64_t>(state.iterations())) state.SkipWithError("a call succeeded while down");
+  fake_db2cli::fail_connects(0);
+}
+BENCHMARK(BM_BreakerOpenFailFast);
+
+} // namespace
+
+BENCHMARK_MAIN();
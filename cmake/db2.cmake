@@ -1,3 +1,20 @@
+# In-process stand-in for the DB2 CLI (tests/fake_db2cli), for tests and
+# benchmarks on machines without the IBM driver or a server
+option(DB2_USE_FAKE_CLI "Link db2_wrapper against the fake DB2 CLI instead of the IBM driver" OFF)
+
+if(DB2_USE_FAKE_CLI)
+    message(STATUS "Using fake DB2 CLI (tests/fake_db2cli)")
+    add_library(fake_db2cli STATIC
+        ${CMAKE_SOURCE_DIR}/tests/fake_db2cli/fake_db2cli.cpp
+    )
+    target_include_directories(fake_db2cli
+        PUBLIC ${CMAKE_SOURCE_DIR}/tests/fake_db2cli/include
+    )
+    target_compile_features(fake_db2cli PUBLIC cxx_std_20)
+    add_library(DB2::db2 ALIAS fake_db2cli)
+    return()
+endif()
+
 # Resolve CLI driver location
 if(DB2_CLI_INSTALL_PREFIX)
     set(DB2_CLI_DRIVER_DIR "${DB2_CLI_INSTALL_PREFIX}/clidriver")
@@ -3,28 +3,57 @@
 //
 // Features:
 // - Safe resource management (RAII) for ENV/DBC/STMT
+// - One process-wide CLI environment shared by all connections
 // - Connect via DSN/UID/PWD or full connection string
 // - Execute SQL (with or without parameters)
 // - Query with row-mapping callback to user-defined struct
+// - Result column metadata described once per execution; name-based lookup
+// - Streaming cursor that pulls rows on demand instead of materializing them
+// - Chunked LOB reads (Row::readLob) into a caller-supplied sink
+// - Typed row mapping into tuples (query_as) resolved at compile time
+// - Columnar results (query_columnar): contiguous per-column arrays + null bitmaps
+// - Per-call query timeouts and cross-thread cancellation
+// - Optional block (array) fetch into column-wise bound buffers
+// - Batch execution with column-wise parameter arrays (one SQLExecute per chunk)
+// - Explicit transactions (begin/commit/rollback) with an RAII guard
 // - Thread-safe: operations on a single Connection are serialized
-// - Exceptions with detailed diagnostic messages on errors
+// - Reconnect after a lost link, gated by a shared circuit breaker with
+//   jittered exponential backoff
+// - LRU cache of prepared statements per connection (keyed by SQL text)
+// - Optional per-statement instrumentation hook (phase timings, rows, errors)
+// - db2::Error exceptions carrying SQLSTATE/native code; message formatted lazily
 
 #pragma once
 
 #include <string>
 #include <string_view>
 #include <vector>
+#include <span>
 #include <variant>
 #include <optional>
 #include <mutex>
+#include <condition_variable>
 #include <functional>
 #include <cstdint>
+#include <cstddef>
+#include <chrono>
+#include <iterator>
 #include <utility>
+#include <memory>
+#include <list>
+#include <array>
+#include <tuple>
+#include <type_traits>
+#include <unordered_map>
+#include <stdexcept>
 
 namespace db2 {
 
-// Parameter value for prepared statements
-using ParamValue = std::variant<std::nullptr_t, int32_t, int64_t, double, std::string>;
+// Parameter value for prepared statements. Strings are bound straight from
+// their storage with an explicit length: std::string owns its text, while
+// std::string_view (and string literals) refer to the caller's buffer, which
+// must stay alive until the execute/query call returns.
+using ParamValue = std::variant<std::nullptr_t, int32_t, int64_t, double, std::string, std::string_view>;
 
 struct Param {
   ParamValue value{};
@@ -35,9 +64,267 @@ struct Param {
   Param(int64_t v) : value(v) {}
   Param(double v) : value(v) {}
   Param(std::string v) : value(std::move(v)) {}
+  Param(std::string_view v) : value(v) {}
+  Param(const char* v) : value(std::string_view(v)) {}
+};
+
+// Per-query options
+struct QueryOptions {
+  // Rows fetched per SQLFetch call. Values > 1 enable block fetch: result
+  // columns are bound with SQLBindCol into column-wise arrays sized from
+  // SQLDescribeCol and Row getters read from those buffers instead of issuing
+  // SQLGetData per column. Result sets with LOB/LONG or very wide columns fall
+  // back to row-at-a-time fetch.
+  std::size_t rowset_size{1};
+
+  // Upper bound on execution time (SQL_ATTR_QUERY_TIMEOUT). The CLI works in
+  // whole seconds, so this is rounded up; 0 = no timeout. A timed out call
+  // throws (SQLSTATE HYT00) and the connection stays usable.
+  std::chrono::milliseconds timeout{0};
+};
+
+// C representation a typed query prefers for a result column. Used as a
+// binding hint in block fetch mode: e.g. a DECIMAL column read as double is
+// bound as SQL_C_DOUBLE instead of text that is parsed per row.
+enum class ColumnType : std::uint8_t { Any, Integer, Real, Text };
+
+// Options for Connection::execute_batch
+struct BatchOptions {
+  // Parameter sets sent per SQLExecute (SQL_ATTR_PARAMSET_SIZE). Larger
+  // inputs are split into chunks of this size; 0 sends everything at once.
+  std::size_t chunk_size{1000};
+
+  // Per-chunk execution timeout, as QueryOptions::timeout
+  std::chrono::milliseconds timeout{0};
+};
+
+// Outcome of one parameter set in a batch (mirrors SQL_PARAM_* status codes)
+enum class ParamStatus : std::uint8_t { Success, SuccessWithInfo, Error, Unused };
+
+struct BatchResult {
+  std::vector<ParamStatus> row_status; // one entry per input row
+  std::size_t rows_processed{0};       // parameter sets the server processed
+  std::int64_t rows_affected{0};       // sum of SQLRowCount over all chunks
+  std::string error_message{};         // diagnostics of the first failing chunk, if any
+
+  bool ok() const noexcept {
+    for (auto s : row_status) {
+      if (s == ParamStatus::Error || s == ParamStatus::Unused) return false;
+    }
+    return true;
+  }
+};
+
+// Counters for the per-connection prepared statement cache
+struct StatementCacheStats {
+  std::uint64_t hits{0};      // SQL text found, prepared HSTMT reused
+  std::uint64_t misses{0};    // SQL text not cached, SQLPrepare issued
+  std::uint64_t evictions{0}; // least recently used statements freed to honor capacity
+  std::size_t size{0};        // statements currently cached
+  std::size_t capacity{0};    // max statements cached (0 = caching disabled)
+};
+
+// One CLI diagnostic record (SQLGetDiagRec)
+struct Diagnostic {
+  std::string sqlstate;        // five characters, e.g. "40001"
+  std::int32_t native_error{0}; // DB2 SQLCODE, e.g. -911
+  std::string message;
+};
+
+// Exception for failed CLI calls. The diagnostic records are read once when
+// the call fails; what() formats them on first use only, so code that just
+// inspects sqlstate()/native_error() (retry decisions, error storms) never
+// builds the text.
+class Error : public std::runtime_error {
+public:
+  Error(const char* context, std::vector<Diagnostic> records);
+
+  const char* what() const noexcept override;
+
+  // First record's SQLSTATE and native code ("" / 0 without diagnostics)
+  std::string_view sqlstate() const noexcept;
+  std::int32_t native_error() const noexcept;
+  const std::vector<Diagnostic>& diagnostics() const noexcept { return data_->records; }
+  // Failing call, e.g. "SQLExecute failed"
+  const char* context() const noexcept { return std::runtime_error::what(); }
+
+private:
+  // Shared so copying the exception never allocates
+  struct Data {
+    std::vector<Diagnostic> records;
+    mutable std::once_flag formatted;
+    mutable std::string text;
+  };
+  std::shared_ptr<const Data> data_;
+};
+
+// Description of one result column (SQLDescribeCol)
+struct ColumnInfo {
+  std::string name;              // as reported; DB2 folds unquoted identifiers to upper case
+  std::int16_t sql_type{0};      // SQL_* data type code
+  std::uint64_t size{0};         // column size (precision for numeric types)
+  std::int16_t decimal_digits{0};
+  bool nullable{true};
+};
+
+// Column metadata of a result set with a precomputed name index. Shared
+// (immutable) between executions of the same SQL; not copyable because the
+// index refers to the column names in place.
+class ResultDescriptor {
+public:
+  explicit ResultDescriptor(std::vector<ColumnInfo> columns);
+
+  ResultDescriptor(const ResultDescriptor&) = delete;
+  ResultDescriptor& operator=(const ResultDescriptor&) = delete;
+
+  std::size_t size() const noexcept { return columns_.size(); }
+  const std::vector<ColumnInfo>& columns() const noexcept { return columns_; }
+  const ColumnInfo& column(int col) const; // 1-based
+
+  // 1-based index of the column named `name` (exact match; the first one if
+  // the name repeats). find() returns std::nullopt, index_of() throws
+  // std::out_of_range when there is no such column.
+  std::optional<int> find(std::string_view name) const noexcept;
+  int index_of(std::string_view name) const;
+
+private:
+  std::vector<ColumnInfo> columns_;
+  std::unordered_map<std::string_view, int> index_{};
+};
+
+// Column-oriented query result (see Connection::query_columnar). Each column
+// is stored in one contiguous array chosen by its bound C type, so callers
+// can scan, filter and sum without per-row dispatch.
+struct ColumnarResult {
+  struct Column {
+    // Which array holds the values: Integer => ints, Real => reals,
+    // Text => chars/offsets (character data as text, binary data raw)
+    ColumnType type{ColumnType::Text};
+    std::vector<std::int64_t> ints;
+    std::vector<double> reals;
+    std::vector<char> chars;               // all values back to back
+    std::vector<std::uint64_t> offsets;    // rows + 1 entries; value i is [offsets[i], offsets[i+1])
+    // Bit i (word i / 64, bit i % 64) is set when row i is NULL. The value
+    // slot of a NULL row is 0 / empty.
+    std::vector<std::uint64_t> nulls;
+
+    bool is_null(std::size_t row) const noexcept { return (nulls[row / 64] >> (row % 64)) & 1u; }
+    std::string_view text(std::size_t row) const noexcept {
+      return {chars.data() + offsets[row], static_cast<std::size_t>(offsets[row + 1] - offsets[row])};
+    }
+  };
+
+  std::shared_ptr<const ResultDescriptor> descriptor; // names and SQL types
+  std::size_t rows{0};
+  std::vector<Column> columns;                        // in result order
+
+  const Column& column(int col) const { return columns.at(static_cast<std::size_t>(col - 1)); } // 1-based
+  const Column& column(std::string_view name) const { return column(descriptor->index_of(name)); }
+};
+
+// Process-wide CLI environment (SQL_HANDLE_ENV with ODBC v3 behaviour).
+// Created on first use and shared by every Connection; the handle is freed
+// when the last holder releases it.
+class Environment {
+public:
+  static std::shared_ptr<Environment> shared();
+
+  ~Environment() noexcept;
+  Environment(const Environment&) = delete;
+  Environment& operator=(const Environment&) = delete;
+
+  std::uintptr_t handle() const noexcept { return henv_; }
+
+private:
+  Environment();
+  std::uintptr_t henv_{0};
+};
+
+// "Database down" circuit breaker shared by the connections to one target.
+//
+// Closed: the server is assumed up and connects proceed. When a connection
+// finds its link broken, exactly one caller probes the server (Probing);
+// other connections wait up to Options::probe_wait for the outcome and
+// otherwise fail fast. A failed probe opens the circuit: connect attempts
+// fail immediately until a jittered, exponentially growing backoff expires,
+// after which the next caller probes again. Any successful connect closes it.
+class CircuitBreaker {
+public:
+  struct Options {
+    std::chrono::milliseconds initial_backoff{100}; // open time after the first failure
+    std::chrono::milliseconds max_backoff{30000};
+    double multiplier{2.0};
+    double jitter{0.2};                             // each backoff is scaled by 1 +- jitter
+    // How long a caller waits for another caller's probe; 0 => fail at once
+    std::chrono::milliseconds probe_wait{0};
+  };
+
+  enum class State : std::uint8_t { Closed, Probing, Open };
+
+  CircuitBreaker() : CircuitBreaker(Options{}) {}
+  explicit CircuitBreaker(Options options);
+
+  CircuitBreaker(const CircuitBreaker&) = delete;
+  CircuitBreaker& operator=(const CircuitBreaker&) = delete;
+
+  // Breaker shared by every Connection to `target` (DSN or connection
+  // string) that has not been given one explicitly; created with default
+  // options and freed with its last user.
+  static std::shared_ptr<CircuitBreaker> for_target(std::string_view target);
+
+  // Admission for one connect attempt; `recovering` marks a reconnect after
+  // a lost link. Returns false if the attempt must fail fast. Every admitted
+  // attempt must be followed by leave().
+  bool enter(bool recovering);
+  // Outcome of an admitted attempt: `reachable` is false when the server
+  // could not be reached (08xxx), which opens the circuit.
+  void leave(bool reachable);
+
+  State state() const;
+  std::uint32_t consecutive_failures() const;
+
+private:
+  std::chrono::milliseconds next_backoff_locked();
+
+  const Options options_;
+  mutable std::mutex mtx_;
+  std::condition_variable cv_;
+  State state_{State::Closed};
+  std::uint32_t failures_{0};
+  std::chrono::steady_clock::time_point retry_at_{};
+};
+
+// Observer for statement-level timings of a Connection (see
+// Connection::set_instrumentation). Callbacks run synchronously on the
+// calling thread while the connection is locked, so they must be cheap and
+// must not call back into the connection. `sql` is the statement text as
+// passed by the caller and is only valid for the duration of the call.
+class Instrumentation {
+public:
+  enum class Phase : std::uint8_t { Prepare, Execute, Fetch };
+
+  virtual ~Instrumentation() = default;
+
+  // A phase of `sql` completed (successfully or not). Prepare is reported
+  // only when SQLPrepare actually runs (statement cache misses). Fetch is
+  // reported once per result set, when it is closed: `elapsed` sums all its
+  // SQLFetch calls and `rows` is the number of rows fetched.
+  virtual void on_phase(std::string_view sql, Phase phase, std::chrono::nanoseconds elapsed,
+                        std::uint64_t rows) noexcept {
+    (void)sql, (void)phase, (void)elapsed, (void)rows;
+  }
+
+  // A call for `sql` failed with `sqlstate`; reported for every failure,
+  // including ones recovered by a reconnect and retry
+  virtual void on_error(std::string_view sql, std::string_view sqlstate) noexcept { (void)sql, (void)sqlstate; }
+
+  // A reconnect after a lost link was attempted
+  virtual void on_reconnect(bool ok) noexcept { (void)ok; }
 };
 
 class Connection {
+  class ResultSet; // executed statement + fetch state (defined in db2.cpp)
+
 public:
   // A lightweight row view for mapping query results
   class Row {
@@ -48,6 +335,42 @@ public:
     std::optional<double>  getDouble(int col) const;
     std::optional<std::string> getString(int col) const;
 
+    // Zero-copy access: views into the bound rowset buffer (block fetch) or a
+    // per-column buffer reused across rows. Valid until the cursor moves to
+    // the next row or the statement is closed.
+    std::optional<std::string_view> getStringView(int col) const;
+    // Raw column bytes (SQL_C_BINARY), e.g. for CHAR FOR BIT DATA / VARBINARY
+    std::optional<std::string_view> getBytes(int col) const;
+
+    // Read a column as text into `out`, reusing its capacity. Returns false
+    // (and clears `out`) for NULL.
+    bool getStringInto(int col, std::string& out) const;
+
+    // Stream a column (typically CLOB/BLOB) to `sink` in chunks of at most
+    // `chunk_size` bytes, so the value is never held in memory as a whole.
+    // Binary columns are passed as raw bytes, everything else as text. The
+    // chunk is only valid during the call; return false from `sink` to stop
+    // early (e.g. the gRPC client went away). Returns the number of bytes
+    // passed to `sink`, or nullopt for NULL. Like the other getters, each
+    // column can be read once per row in row-at-a-time mode.
+    //
+    //   row.readLob(row.col("DOC"), [&](std::string_view chunk) {
+    //     reply.set_data(chunk.data(), chunk.size());
+    //     return writer->Write(reply);
+    //   });
+    using LobSink = std::function<bool(std::string_view chunk)>;
+    static constexpr std::size_t kLobChunkSize = 64 * 1024;
+    std::optional<std::uint64_t> readLob(int col, const LobSink& sink,
+                                         std::size_t chunk_size = kLobChunkSize) const;
+
+    // Column metadata of the result, described once per execution (or taken
+    // from Connection::describe's cache for the same SQL).
+    const ResultDescriptor& descriptor() const;
+    // 1-based index of a column by name, for use with the getters:
+    //   row.getInt64(row.col("ORDER_ID"))
+    // Throws std::out_of_range if the result has no such column.
+    int col(std::string_view name) const { return descriptor().index_of(name); }
+
     // Row is a non-owning view tied to the lifetime of an active statement.
     // To prevent escaping the callback and becoming dangling, disallow copy/move.
     Row(const Row&) = delete;
@@ -57,8 +380,94 @@ public:
 
   private:
     friend class Connection;
-    explicit Row(std::uintptr_t hstmt) : hstmt_(hstmt) {}
-    std::uintptr_t hstmt_{}; // HSTMT stored as integral to avoid exposing CLI headers here
+    Row(const ResultSet* rs, std::size_t index) : rs_(rs), index_(index) {}
+    const ResultSet* rs_{nullptr}; // statement and (in block mode) bound column buffers
+    std::size_t index_{0};         // row within the current rowset
+  };
+
+  // Pull-based cursor over a query result (see open_cursor). Keeps the
+  // statement open and the connection's mutex locked until it is closed or
+  // destroyed, so memory stays bounded by one row (one rowset in block mode)
+  // regardless of result size. Move-only; because it owns the lock it must
+  // be consumed and destroyed on the thread that opened it.
+  class Cursor {
+  public:
+    Cursor() noexcept;
+    ~Cursor();
+    Cursor(Cursor&&) noexcept;
+    Cursor& operator=(Cursor&&) noexcept;
+    Cursor(const Cursor&) = delete;
+    Cursor& operator=(const Cursor&) = delete;
+
+    // Advance to the next row. Returns nullptr at end of data (the cursor is
+    // then closed). The returned row is valid until the next call.
+    const Row* next();
+
+    // Release the statement and the connection early
+    void close() noexcept;
+    bool is_open() const noexcept { return state_ != nullptr; }
+
+    // Single-pass input iteration: for (const auto& row : cursor) { ... }
+    class iterator {
+    public:
+      using iterator_category = std::input_iterator_tag;
+      using value_type = Row;
+      using difference_type = std::ptrdiff_t;
+      using pointer = const Row*;
+      using reference = const Row&;
+
+      iterator() noexcept = default;
+      reference operator*() const noexcept { return *row_; }
+      pointer operator->() const noexcept { return row_; }
+      iterator& operator++() { row_ = cursor_->next(); return *this; }
+      void operator++(int) { ++*this; }
+      friend bool operator==(const iterator& a, const iterator& b) noexcept { return a.row_ == b.row_; }
+
+    private:
+      friend class Cursor;
+      iterator(Cursor* cursor, const Row* row) noexcept : cursor_(cursor), row_(row) {}
+      Cursor* cursor_{nullptr};
+      const Row* row_{nullptr};
+    };
+
+    iterator begin() { return iterator{this, next()}; }
+    iterator end() noexcept { return iterator{}; }
+
+  private:
+    friend class Connection;
+    struct State; // lock + statement + fetch state (defined in db2.cpp)
+    explicit Cursor(std::unique_ptr<State> state) noexcept;
+    std::unique_ptr<State> state_;
+  };
+
+  // RAII transaction scope: begin() on construction, rollback() on
+  // destruction unless commit() or rollback() was called first.
+  //   db2::Connection::Transaction tx(conn);
+  //   conn.execute(...); conn.execute(...);
+  //   tx.commit();
+  class Transaction {
+  public:
+    explicit Transaction(Connection& conn) : conn_(&conn) { conn.begin(); }
+    ~Transaction() {
+      if (conn_) conn_->rollback();
+    }
+
+    Transaction(const Transaction&) = delete;
+    Transaction& operator=(const Transaction&) = delete;
+    Transaction(Transaction&& other) noexcept : conn_(std::exchange(other.conn_, nullptr)) {}
+    Transaction& operator=(Transaction&&) = delete;
+
+    // Throws std::logic_error once the scope has been committed or rolled back
+    void commit() {
+      if (!conn_) throw std::logic_error("DB2 commit on a finished transaction scope");
+      std::exchange(conn_, nullptr)->commit();
+    }
+    // Returns false once the scope has been committed or rolled back
+    bool rollback() noexcept { return conn_ && std::exchange(conn_, nullptr)->rollback(); }
+    bool active() const noexcept { return conn_ != nullptr; }
+
+  private:
+    Connection* conn_;
   };
 
   Connection();
@@ -76,32 +485,139 @@ public:
   // Example: "DATABASE=db;HOSTNAME=host;PORT=50000;PROTOCOL=TCPIP;UID=user;PWD=pass;"
   void connect_with_conn_str(std::string_view conn_str);
 
+  // True while the link is up. After a lost link this is false until a
+  // later call reconnects (see set_circuit_breaker).
   bool is_connected() const noexcept;
   void disconnect() noexcept;
 
+  // Breaker gating this connection's connects and reconnects. Defaults to
+  // CircuitBreaker::for_target(DSN or connection string) on first connect.
+  void set_circuit_breaker(std::shared_ptr<CircuitBreaker> breaker);
+  std::shared_ptr<CircuitBreaker> circuit_breaker() const;
+
+  // Statement instrumentation; null (the default) disables it, leaving no
+  // per-statement cost beyond a pointer check
+  void set_instrumentation(std::shared_ptr<Instrumentation> instrumentation);
+  std::shared_ptr<Instrumentation> instrumentation() const;
+
+  // Shared environment this connection's DBC handle was allocated from
+  const std::shared_ptr<Environment>& environment() const noexcept { return env_; }
+
+  // Prepared statement cache. Parameterized execute/query reuse the prepared
+  // HSTMT for identical SQL text instead of calling SQLPrepare every time.
+  // Cached statements are freed on disconnect and reconnect.
+  static constexpr std::size_t kDefaultStatementCacheCapacity = 32;
+  void set_statement_cache_capacity(std::size_t capacity); // 0 disables caching
+  StatementCacheStats statement_cache_stats() const;
+
+  // Result column metadata for `sql`, prepared but not executed. Cached per
+  // SQL text until disconnect/reconnect; queries running the same text reuse
+  // it instead of describing their result again. Statements without a result
+  // set yield an empty descriptor.
+  std::shared_ptr<const ResultDescriptor> describe(std::string_view sql);
+
   // Execute a non-query SQL statement (DDL/DML without result set)
   void execute(std::string_view sql);
   void execute(std::string_view sql, const std::vector<Param>& params);
+  // With per-call options (only `timeout` applies to statements without results)
+  void execute(std::string_view sql, const std::vector<Param>& params, const QueryOptions& options);
+
+  // Explicit transactions. begin() turns autocommit off so that subsequent
+  // statements accumulate into one unit of work (one log force at commit).
+  // commit()/rollback() end it and restore autocommit. A connection lost
+  // mid-transaction is not reconnected transparently: the failing call
+  // throws and the transaction must be rolled back and retried by the caller.
+  // commit() throws on failure (the transaction is over either way).
+  // rollback() never throws; it returns false if the server could not be
+  // reached (the work is discarded with the link, and the connection is
+  // re-established for the next call).
+  void begin();
+  void commit();
+  bool rollback() noexcept;
+  bool in_transaction() const noexcept;
+
+  // Abort the statement currently executing or fetching on this connection
+  // (SQLCancel). Safe to call from any thread while another thread is inside
+  // execute/query/a cursor; the interrupted call throws (SQLSTATE HY008).
+  // Returns false if nothing was running.
+  bool cancel() noexcept;
+
+  // Execute a DML statement once per row of parameters using column-wise
+  // parameter arrays, so each chunk of rows costs a single round trip.
+  // All rows must have the same number of parameters; within a column,
+  // values must be NULL or of one kind (integers widen to int64/double).
+  // Rows rejected by the server are reported in BatchResult::row_status
+  // instead of throwing; failures without per-row status throw.
+  BatchResult execute_batch(std::string_view sql, std::span<const std::vector<Param>> rows,
+                            const BatchOptions& options = {});
+
+  // Execute a query and return a cursor that fetches rows as they are pulled.
+  // The connection stays locked for the cursor's lifetime; other calls on
+  // this connection from the same thread would deadlock until it is closed.
+  Cursor open_cursor(std::string_view sql, const std::vector<Param>& params = {},
+                     const QueryOptions& options = {});
+
+  // Execute a query and map each row into a tuple-like type whose elements are
+  // int32_t, int64_t, double, std::string or std::optional of those, e.g.
+  //   auto rows = conn.query_as<std::tuple<int32_t, std::string, std::optional<double>>>(sql);
+  // Element i is read from column i + 1; a NULL in a non-optional element
+  // throws. Conversions are chosen at compile time and rows are pulled through
+  // a cursor, so there is no per-row type erasure.
+  template <class Tuple>
+  std::vector<Tuple> query_as(std::string_view sql, const std::vector<Param>& params = {},
+                              const QueryOptions& options = {});
+
+  // Execute a query and collect the whole result column-wise. Rows are block
+  // fetched into SQLBindCol arrays (rowset_size <= 1 uses
+  // kColumnarRowsetSize) and copied out one column at a time. Integer
+  // columns land in ColumnarResult::Column::ints, floating point in reals,
+  // everything else as text; `types` can ask for DECIMAL columns as Real
+  // (or, with scale 0, Integer) as in query_as. Results that cannot be bound
+  // (LOBs, very wide rows) are read row by row into the same layout.
+  static constexpr std::size_t kColumnarRowsetSize = 1024;
+  ColumnarResult query_columnar(std::string_view sql, const std::vector<Param>& params = {},
+                                const QueryOptions& options = {}, std::span<const ColumnType> types = {});
 
   // Execute a query and map each row to a user-defined type using the mapper.
   // Mapper signature: T mapper(const Row&)
   template <class T, class Mapper>
   std::vector<T> query(std::string_view sql, Mapper&& mapper) {
-    return query_impl<T>(sql, nullptr, 0, std::forward<Mapper>(mapper));
+    return query_impl<T>(sql, nullptr, 0, QueryOptions{}, std::forward<Mapper>(mapper));
   }
 
   template <class T, class Mapper>
   std::vector<T> query(std::string_view sql, const std::vector<Param>& params, Mapper&& mapper) {
-    return query_impl<T>(sql, params.data(), static_cast<int>(params.size()), std::forward<Mapper>(mapper));
+    return query_impl<T>(sql, params.data(), static_cast<int>(params.size()), QueryOptions{}, std::forward<Mapper>(mapper));
+  }
+
+  // Same as above with per-query options (e.g. block fetch rowset size)
+  template <class T, class Mapper>
+  std::vector<T> query(std::string_view sql, const QueryOptions& options, Mapper&& mapper) {
+    return query_impl<T>(sql, nullptr, 0, options, std::forward<Mapper>(mapper));
+  }
+
+  template <class T, class Mapper>
+  std::vector<T> query(std::string_view sql, const std::vector<Param>& params, const QueryOptions& options, Mapper&& mapper) {
+    return query_impl<T>(sql, params.data(), static_cast<int>(params.size()), options, std::forward<Mapper>(mapper));
   }
 
 private:
   // PIMPL-friendly internal pointers (avoid exposing DB2 headers in this public header)
-  std::uintptr_t henv_{0};
+  std::shared_ptr<Environment> env_{};
   std::uintptr_t hdbc_{0};
-  bool connected_{false};
   mutable std::mutex mtx_{}; // Serialize operations on the connection
 
+  // Link state machine:
+  //   Disconnected --connect_with_*--> Connected --lost link--> Broken
+  //   Broken --reconnect admitted by breaker_ and succeeded--> Connected
+  //   any --disconnect()--> Disconnected
+  // Broken connections reconnect on their next call instead of failing for
+  // good; while the breaker is open that call fails fast.
+  enum class LinkState : std::uint8_t { Disconnected, Connected, Broken };
+  LinkState link_{LinkState::Disconnected};
+  std::shared_ptr<CircuitBreaker> breaker_{};
+  std::shared_ptr<Instrumentation> instr_{};
+
   // Reconnection support
   enum class ConnMode { None, Dsn, ConnStr };
   ConnMode mode_{ConnMode::None};
@@ -110,26 +626,164 @@ private:
   std::string pwd_{};
   std::string conn_str_{};
 
+  // Prepared statement cache: LRU list (front = most recently used) plus an
+  // index keyed by views into the list nodes' SQL text (nodes are stable).
+  struct CachedStatement {
+    std::string sql;
+    std::uintptr_t hstmt{0};
+  };
+  using StatementList = std::list<CachedStatement>;
+  StatementList stmt_lru_{};
+  std::unordered_map<std::string_view, StatementList::iterator> stmt_index_{};
+  std::size_t stmt_cache_capacity_{kDefaultStatementCacheCapacity};
+  StatementCacheStats stmt_stats_{};
+  // Bumped whenever the DBC is disconnected; statement handles checked out
+  // under an older epoch were already released by the driver.
+  std::uint64_t conn_epoch_{0};
+  // Autocommit is off between begin() and commit()/rollback()
+  bool in_txn_{false};
+
+  // describe() results keyed by SQL text (heterogeneous lookup by view)
+  struct SqlHash {
+    using is_transparent = void;
+    std::size_t operator()(std::string_view sql) const noexcept { return std::hash<std::string_view>{}(sql); }
+  };
+  std::unordered_map<std::string, std::shared_ptr<const ResultDescriptor>, SqlHash, std::equal_to<>> describe_cache_{};
+  std::shared_ptr<const ResultDescriptor> cached_descriptor_locked(std::string_view sql) const;
+
+  // Report a failed call for `sql` to instr_, if set
+  void note_error_locked(std::string_view sql, const Error& err) const noexcept;
+
+  class StatementLease; // RAII checkout of a prepared HSTMT (defined in db2.cpp)
+
+  // Statement currently executing/fetching, for cancel() from other threads.
+  // Guarded by cancel_mtx_ (not mtx_, which the running call holds).
+  mutable std::mutex cancel_mtx_{};
+  std::uintptr_t active_stmt_{0};
+
   void ensure_connected_locked();
   void cleanup_locked() noexcept;
-  bool try_reconnect_locked() noexcept; // attempt reconnect using stored parameters
+  bool try_reconnect_locked() noexcept; // drop the broken link, then reconnect_locked()
+  bool reconnect_locked() noexcept;     // Broken -> Connected using stored parameters, if the breaker admits it
+  int connect_stored_locked() noexcept; // SQLConnect/SQLDriverConnect with stored parameters; returns SQLRETURN
+  void drop_link_locked() noexcept;     // free statements and disconnect the DBC
+  bool end_transaction_locked(bool commit) noexcept; // rollback unless committed, autocommit back on
+  void clear_statement_cache_locked() noexcept;
+  void trim_statement_cache_locked() noexcept;
 
-  void execute_prepared_locked(std::string_view sql, const Param* params, int param_count);
+  void execute_direct_locked(std::string_view sql, std::chrono::milliseconds timeout);
+  void execute_prepared_locked(std::string_view sql, const Param* params, int param_count,
+                               std::chrono::milliseconds timeout);
+  void execute_batch_chunk_locked(std::string_view sql, std::span<const std::vector<Param>> rows,
+                                  std::size_t first_row, std::chrono::milliseconds timeout,
+                                  BatchResult& result);
 
   template <class T, class Mapper>
-  std::vector<T> query_impl(std::string_view sql, const Param* params, int param_count, Mapper&& mapper);
+  std::vector<T> query_impl(std::string_view sql, const Param* params, int param_count,
+                            const QueryOptions& options, Mapper&& mapper);
+
+  // open_cursor with per-column binding hints (may be empty)
+  Cursor open_cursor_impl(std::string_view sql, const Param* params, int param_count,
+                          const QueryOptions& options, std::span<const ColumnType> column_types);
+
+  template <class Tuple, std::size_t... I>
+  static void read_tuple(const Row& row, Tuple& out, std::index_sequence<I...>);
 
   // Non-templated core that executes a query and invokes a callback per row
   void query_to_callback(std::string_view sql, const Param* params, int param_count,
-                         const std::function<void(const Row&)>& on_row);
+                         const QueryOptions& options, const std::function<void(const Row&)>& on_row);
+};
+
+// ---- Typed column conversion (query_as) ---------------------------------------
+
+// ColumnTraits<T>::read stores column `col` of `row` in `out` and returns
+// false for NULL. Specialize for additional element types.
+template <class T>
+struct ColumnTraits {
+  static_assert(sizeof(T) == 0, "query_as: unsupported column type");
+};
+
+template <>
+struct ColumnTraits<int32_t> {
+  static constexpr ColumnType type = ColumnType::Integer;
+  static bool read(const Connection::Row& row, int col, int32_t& out) {
+    auto v = row.getInt32(col);
+    if (v) out = *v;
+    return v.has_value();
+  }
+};
+
+template <>
+struct ColumnTraits<int64_t> {
+  static constexpr ColumnType type = ColumnType::Integer;
+  static bool read(const Connection::Row& row, int col, int64_t& out) {
+    auto v = row.getInt64(col);
+    if (v) out = *v;
+    return v.has_value();
+  }
+};
+
+template <>
+struct ColumnTraits<double> {
+  static constexpr ColumnType type = ColumnType::Real;
+  static bool read(const Connection::Row& row, int col, double& out) {
+    auto v = row.getDouble(col);
+    if (v) out = *v;
+    return v.has_value();
+  }
+};
+
+template <>
+struct ColumnTraits<std::string> {
+  static constexpr ColumnType type = ColumnType::Text;
+  static bool read(const Connection::Row& row, int col, std::string& out) {
+    return row.getStringInto(col, out);
+  }
+};
+
+template <class T>
+struct ColumnTraits<std::optional<T>> {
+  static constexpr ColumnType type = ColumnTraits<T>::type;
+  static bool read(const Connection::Row& row, int col, std::optional<T>& out) {
+    if (!ColumnTraits<T>::read(row, col, out.emplace())) out.reset();
+    return true; // NULL is a valid value
+  }
 };
 
 // ---- Template implementations -------------------------------------------------
 
+template <class Tuple, std::size_t... I>
+inline void Connection::read_tuple(const Row& row, Tuple& out, std::index_sequence<I...>) {
+  auto read_one = [&row](auto& element, int col) {
+    using E = std::remove_cvref_t<decltype(element)>;
+    if (!ColumnTraits<E>::read(row, col, element)) {
+      throw std::runtime_error("query_as: NULL in non-optional column " + std::to_string(col));
+    }
+  };
+  (read_one(std::get<I>(out), static_cast<int>(I) + 1), ...);
+}
+
+template <class Tuple>
+inline std::vector<Tuple> Connection::query_as(std::string_view sql, const std::vector<Param>& params,
+                                               const QueryOptions& options) {
+  constexpr std::size_t N = std::tuple_size_v<Tuple>;
+  static constexpr auto types = []<std::size_t... I>(std::index_sequence<I...>) {
+    return std::array<ColumnType, N>{ColumnTraits<std::tuple_element_t<I, Tuple>>::type...};
+  }(std::make_index_sequence<N>{});
+
+  auto cursor = open_cursor_impl(sql, params.data(), static_cast<int>(params.size()), options, types);
+  std::vector<Tuple> out;
+  while (const Row* row = cursor.next()) {
+    read_tuple(*row, out.emplace_back(), std::make_index_sequence<N>{});
+  }
+  return out;
+}
+
 template <class T, class Mapper>
-inline std::vector<T> Connection::query_impl(std::string_view sql, const Param* params, int param_count, Mapper&& mapper) {
+inline std::vector<T> Connection::query_impl(std::string_view sql, const Param* params, int param_count,
+                                             const QueryOptions& options, Mapper&& mapper) {
   std::vector<T> out;
-  this->query_to_callback(sql, params, param_count, [&](const Connection::Row& row){
+  this->query_to_callback(sql, params, param_count, options, [&](const Connection::Row& row){
     out.emplace_back(mapper(row));
   });
   return out;
@@ -0,0 +1,74 @@
+#pragma once
+
+#include <prometheus/counter.h>
+#include <prometheus/family.h>
+#include <prometheus/histogram.h>
+#include <prometheus/registry.h>
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+
+#include "db2/db2.hpp"
+
+// Prometheus implementation of db2::Instrumentation. Statements are labelled
+// by their fingerprint (sql::anonymize of the SQL text, whitespace collapsed),
+// which is computed once per distinct SQL string and cached.
+//
+//   auto db2_metrics = std::make_shared<Db2Metrics>(registry);
+//   conn.set_instrumentation(db2_metrics);
+class Db2Metrics : public db2::Instrumentation {
+public:
+    // At most max_statements series: the first max_statements - 1 distinct
+    // fingerprints get their own, the rest share "other" to bound label
+    // cardinality; longer fingerprints are truncated.
+    explicit Db2Metrics(const std::shared_ptr<prometheus::Registry>& registry,
+                        std::size_t max_statements = 1000,
+                        std::size_t max_fingerprint_length = 256);
+
+    void on_phase(std::string_view sql, Phase phase, std::chrono::nanoseconds elapsed,
+                  std::uint64_t rows) noexcept override;
+    void on_error(std::string_view sql, std::string_view sqlstate) noexcept override;
+    void on_reconnect(bool ok) noexcept override;
+
+    // Fingerprint label used for `sql`
+    static std::string fingerprint(std::string_view sql, std::size_t max_length = 256);
+
+    prometheus::Family<prometheus::Histogram>& phase_histogram_family;
+    prometheus::Family<prometheus::Histogram>& rows_histogram_family;
+    prometheus::Family<prometheus::Counter>& error_counter_family;
+    prometheus::Family<prometheus::Counter>& reconnect_counter_family;
+
+private:
+    struct Statement {
+        std::string fingerprint;
+        prometheus::Histogram* prepare;
+        prometheus::Histogram* execute;
+        prometheus::Histogram* fetch;
+        prometheus::Histogram* rows;
+    };
+
+    struct SqlHash {
+        using is_transparent = void;
+        std::size_t operator()(std::string_view sql) const noexcept { return std::hash<std::string_view>{}(sql); }
+    };
+
+    // Series for `sql`; caller holds mtx_
+    Statement& statement_locked(std::string_view sql);
+
+    const std::size_t max_statements_;
+    const std::size_t max_fingerprint_length_;
+    prometheus::Counter& reconnects_ok_;
+    prometheus::Counter& reconnects_failed_;
+
+    std::mutex mtx_;
+    // Keyed by raw SQL text; statements sharing a fingerprint share series
+    std::unordered_map<std::string, Statement, SqlHash, std::equal_to<>> statements_;
+    std::unordered_map<std::string, Statement> by_fingerprint_;
+};
@@ -0,0 +1,161 @@
+// async_executor.h
+// Asynchronous DB2 execution for callback-based (reactor) gRPC handlers.
+// Header-only; builds on resource::ResourcePool and worker::WorkerPool.
+//
+// gRPC callback handlers run on the library's callback executor threads, which
+// must never block. AsyncExecutor moves both the (possibly blocking) pool
+// acquire and the DB2 calls onto a dedicated worker pool, then reports the
+// outcome through a completion callback on that worker thread. Completing the
+// RPC from there (e.g. reactor->Finish(...)) is allowed by gRPC.
+//
+// Example:
+//
+//   ServerUnaryReactor* SayHello(CallbackServerContext* ctx, const HelloRequest* req,
+//                                HelloReply* reply) override {
+//     auto* reactor = ctx->DefaultReactor();
+//     bool queued = db_->query_as<std::tuple<std::string>>(
+//         "SELECT GREETING FROM APP.GREETINGS WHERE NAME = ?", {db2::Param{req->name()}},
+//         [reactor, reply](db2::AsyncResult<std::vector<std::tuple<std::string>>> r) {
+//           if (!r.ok()) { reactor->Finish(grpc::Status(grpc::StatusCode::UNAVAILABLE, "db error")); return; }
+//           reply->set_message(r.value->empty() ? "Hello" : std::get<0>(r.value->front()));
+//           reactor->Finish(grpc::Status::OK);
+//         });
+//     if (!queued) reactor->Finish(grpc::Status(grpc::StatusCode::RESOURCE_EXHAUSTED, "db queue full"));
+//     return reactor;
+//   }
+
+#pragma once
+
+#include <cstddef>
+#include <exception>
+#include <memory>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "db2/db2.hpp"
+#include "resource/resource_pool.hpp"
+#include "worker/WorkerPool.h"
+
+namespace db2 {
+
+// Outcome passed to completion callbacks: either a value or the exception
+// thrown while acquiring the connection or running the work.
+template <class T>
+struct AsyncResult {
+  std::optional<T> value{};
+  std::exception_ptr error{};
+
+  bool ok() const noexcept { return !error; }
+
+  // Value on success; rethrows the captured exception otherwise
+  T& get() {
+    if (error) std::rethrow_exception(error);
+    return *value;
+  }
+};
+
+template <>
+struct AsyncResult<void> {
+  std::exception_ptr error{};
+
+  bool ok() const noexcept { return !error; }
+  void get() const {
+    if (error) std::rethrow_exception(error);
+  }
+};
+
+// Runs work against pooled connections on dedicated DB threads. `Conn` is the
+// pooled resource type (db2::Connection in production).
+template <class Conn>
+class BasicAsyncExecutor {
+public:
+  using Pool = resource::ResourcePool<Conn>;
+
+  struct Options {
+    // DB worker threads; bounds the number of concurrently used connections,
+    // so it is usually sized to the pool's max_size.
+    std::size_t thread_count = 4;
+    // Pending requests beyond this are rejected (post returns false) instead
+    // of queueing without bound. 0 => unbounded.
+    std::size_t max_queue = 1024;
+    std::string name = "db2-async";
+  };
+
+  BasicAsyncExecutor(std::shared_ptr<Pool> pool, Options options)
+      : pool_(std::move(pool)),
+        workers_({
+            .thread_count = options.thread_count,
+            .parallelism = 0,
+            .max_queue = options.max_queue,
+            .drain_on_shutdown = true,
+            .name = std::move(options.name),
+        }) {
+    if (!pool_) throw std::invalid_argument("BasicAsyncExecutor: pool must not be null");
+  }
+
+  explicit BasicAsyncExecutor(std::shared_ptr<Pool> pool)
+      : BasicAsyncExecutor(std::move(pool), Options{}) {}
+
+  BasicAsyncExecutor(const BasicAsyncExecutor&) = delete;
+  BasicAsyncExecutor& operator=(const BasicAsyncExecutor&) = delete;
+
+  // Drains queued work: every accepted request gets its completion callback.
+  ~BasicAsyncExecutor() { workers_.shutdown(true); }
+
+  // Queue `work(Conn&)` and invoke `done(AsyncResult<R>)` with its result,
+  // where R is work's return type. Never blocks the caller: returns false if
+  // the queue is full or the executor is shutting down, in which case `done`
+  // is not called.
+  template <class Work, class Done>
+  bool post(Work&& work, Done&& done) {
+    using R = std::invoke_result_t<Work&, Conn&>;
+    return workers_.try_post(
+        [pool = pool_, work = std::forward<Work>(work), done = std::forward<Done>(done)]() mutable {
+          AsyncResult<R> result;
+          try {
+            auto conn = pool->acquire();
+            if constexpr (std::is_void_v<R>) {
+              work(*conn);
+            } else {
+              result.value.emplace(work(*conn));
+            }
+          } catch (...) {
+            result.error = std::current_exception();
+          }
+          // The connection is back in the pool before the RPC completes
+          done(std::move(result));
+        });
+  }
+
+  // Conveniences for the common Connection calls. Arguments are copied into
+  // the request so callers need not keep them alive; the exception is
+  // std::string_view params, whose text must outlive `done`.
+  template <class Done>
+  bool execute(std::string_view sql, std::vector<Param> params, Done&& done) {
+    return post([sql = std::string(sql), params = std::move(params)](Conn& c) { c.execute(sql, params); },
+                std::forward<Done>(done));
+  }
+
+  template <class Tuple, class Done>
+  bool query_as(std::string_view sql, std::vector<Param> params, Done&& done) {
+    return post([sql = std::string(sql), params = std::move(params)](Conn& c) {
+                  return c.template query_as<Tuple>(sql, params);
+                },
+                std::forward<Done>(done));
+  }
+
+  std::size_t queued() const noexcept { return workers_.queued_estimate(); }
+  std::size_t active() const noexcept { return workers_.active(); }
+
+private:
+  std::shared_ptr<Pool> pool_;
+  worker::WorkerPool workers_;
+};
+
+using AsyncExecutor = BasicAsyncExecutor<Connection>;
+
+} // namespace db2
@@ -1,12 +1,13 @@
 #include "db2/db2.hpp"
 
 #include <stdexcept>
-#include <sstream>
 #include <vector>
 #include <cstring>
 #include <algorithm>
 #include <type_traits>
 #include <limits>
+#include <charconv>
+#include <random>
 
 // Include DB2 CLI umbrella header (brings in required ODBC types)
 #include <sqlcli1.h>
@@ -31,33 +32,41 @@ inline SQLINTEGER safe_integer(size_t n, const char* what) {
   return static_cast<SQLINTEGER>(n);
 }
 
-inline std::string diag_message(SQLSMALLINT handleType, SQLHANDLE handle) {
-  SQLSMALLINT i = 1;
-  SQLINTEGER nativeError = 0;
+// Read every diagnostic record of `handle` (at most 20). Messages longer
+// than the stack buffer are read again at their full length.
+inline std::vector<db2::Diagnostic> collect_diag(SQLSMALLINT handleType, SQLHANDLE handle) {
+  std::vector<db2::Diagnostic> records;
   SQLCHAR sqlState[6] = {0};
   SQLCHAR messageText[1024];
-  SQLSMALLINT textLength = 0;
-  std::ostringstream oss;
-
-  while (true) {
+  for (SQLSMALLINT i = 1; i <= 20; ++i) {
+    SQLINTEGER nativeError = 0;
+    SQLSMALLINT textLength = 0;
     SQLRETURN rc = SQLGetDiagRec(handleType, handle, i, sqlState, &nativeError,
                                  messageText, sizeof(messageText), &textLength);
     if (!(rc == SQL_SUCCESS || rc == SQL_SUCCESS_WITH_INFO)) break;
-    oss << "[" << sqlState << "] (" << nativeError << ") "
-        << std::string(reinterpret_cast<char*>(messageText), textLength);
-    ++i;
-    if (i > 20) break; // avoid infinite loops
-    if (i > 1) oss << " | ";
-  }
-  std::string out = oss.str();
-  if (out.empty()) out = "DB2 CLI error (no diagnostics)";
-  return out;
+    auto& rec = records.emplace_back();
+    rec.sqlstate.assign(reinterpret_cast<const char*>(sqlState), std::strlen(reinterpret_cast<const char*>(sqlState)));
+    rec.native_error = nativeError;
+    if (textLength >= static_cast<SQLSMALLINT>(sizeof(messageText))) {
+      rec.message.resize(static_cast<std::size_t>(textLength) + 1);
+      SQLGetDiagRec(handleType, handle, i, sqlState, &nativeError,
+                    reinterpret_cast<SQLCHAR*>(rec.message.data()), static_cast<SQLSMALLINT>(rec.message.size()),
+                    &textLength);
+      rec.message.resize(static_cast<std::size_t>(textLength));
+    } else if (textLength > 0) {
+      rec.message.assign(reinterpret_cast<const char*>(messageText), static_cast<std::size_t>(textLength));
+    }
+  }
+  return records;
 }
 
-inline void throw_diag(SQLSMALLINT handleType, SQLHANDLE handle, const char* where) {
-  std::ostringstream oss;
-  oss << where << ": " << diag_message(handleType, handle);
-  throw std::runtime_error(oss.str());
+// Exception for a failed call on `handle`, diagnostics collected once
+inline db2::Error diag_error(const char* where, SQLSMALLINT handleType, SQLHANDLE handle) {
+  return db2::Error(where, collect_diag(handleType, handle));
+}
+
+[[noreturn]] inline void throw_diag(SQLSMALLINT handleType, SQLHANDLE handle, const char* where) {
+  throw diag_error(where, handleType, handle);
 }
 
 inline std::string first_sql_state(SQLSMALLINT handleType, SQLHANDLE handle) {
@@ -72,12 +81,403 @@ inline std::string first_sql_state(SQLSMALLINT handleType, SQLHANDLE handle) {
 inline bool is_connection_broken_sqlstate(std::string_view state) {
   if (state.size() >= 2 && state[0] == '0' && state[1] == '8') return true; // 08xxx
   // Common CLI/ODBC timeouts/comm failures that imply reconnect
-  return (state == "40003" || state == "HYT00" || state == "HYT01" || state == "58004");
+  // HYT00 is deliberately absent: it reports an expired query timeout, which
+  // leaves the connection intact.
+  return (state == "40003" || state == "HYT01" || state == "58004");
 }
 
 // Non-null placeholder for NULL parameter bindings (some drivers dereference ValuePtr even for NULL)
 static unsigned char g_null_param_dummy = 0;
 
+// Storage for bound parameter values and indicators; must outlive SQLExecute.
+// String parameters are bound from the caller's storage and need none.
+struct BoundParams {
+  std::vector<int32_t> i32_vals;
+  std::vector<int64_t> i64_vals;
+  std::vector<double>  dbl_vals;
+  std::vector<SQLLEN> ind_vals;
+};
+
+// Text of a string parameter (owned or viewed), or nullptr for other kinds
+inline const std::string_view* param_text(const db2::ParamValue& v, std::string_view& scratch) {
+  if (auto ps = std::get_if<std::string>(&v)) { scratch = *ps; return &scratch; }
+  return std::get_if<std::string_view>(&v);
+}
+
+// Bind all parameters to a prepared statement. Returns the first failing
+// SQLBindParameter return code, or SQL_SUCCESS.
+inline SQLRETURN bind_params(SQLHSTMT hstmt, const db2::Param* params, int param_count, BoundParams& bound) {
+  // Reserve up front so pointers to elements stay valid while binding
+  bound.i32_vals.reserve(param_count);
+  bound.i64_vals.reserve(param_count);
+  bound.dbl_vals.reserve(param_count);
+  bound.ind_vals.assign(param_count, 0);
+
+  for (int i = 0; i < param_count; ++i) {
+    SQLUSMALLINT paramNum = static_cast<SQLUSMALLINT>(i + 1);
+    SQLSMALLINT cType = 0;
+    SQLSMALLINT sqlType = 0;
+    SQLULEN colDef = 0;
+    SQLSMALLINT scale = 0;
+    SQLPOINTER valPtr = nullptr;
+    SQLLEN* indPtr = &bound.ind_vals[i];
+
+    const auto& v = params[i].value;
+    SQLLEN buffer_len = 0;
+    if (std::holds_alternative<std::nullptr_t>(v)) {
+      // Use non-null dummy pointer and mark indicator as NULL
+      cType = SQL_C_CHAR; sqlType = SQL_VARCHAR; colDef = 1; scale = 0; valPtr = &g_null_param_dummy; *indPtr = SQL_NULL_DATA; buffer_len = 1;
+    } else if (auto pv = std::get_if<int32_t>(&v)) {
+      cType = SQL_C_SLONG; sqlType = SQL_INTEGER; bound.i32_vals.push_back(*pv); valPtr = &bound.i32_vals.back(); *indPtr = sizeof(int32_t); buffer_len = sizeof(int32_t);
+    } else if (auto pv = std::get_if<int64_t>(&v)) {
+      cType = SQL_C_SBIGINT; sqlType = SQL_BIGINT; bound.i64_vals.push_back(*pv); valPtr = &bound.i64_vals.back(); *indPtr = sizeof(int64_t); buffer_len = sizeof(int64_t);
+    } else if (auto pv = std::get_if<double>(&v)) {
+      cType = SQL_C_DOUBLE; sqlType = SQL_DOUBLE; bound.dbl_vals.push_back(*pv); valPtr = &bound.dbl_vals.back(); *indPtr = sizeof(double); buffer_len = sizeof(double);
+    } else if (std::string_view text; auto pv = param_text(v, text)) {
+      // Bind the caller's bytes with an explicit length (no copy, no NUL
+      // terminator needed) and describe the parameter by its real size
+      cType = SQL_C_CHAR; sqlType = SQL_VARCHAR;
+      const SQLINTEGER len = safe_integer(pv->size(), "string parameter");
+      colDef = std::max<SQLULEN>(static_cast<SQLULEN>(len), 1);
+      scale = 0;
+      valPtr = pv->empty() ? static_cast<SQLPOINTER>(&g_null_param_dummy)
+                           : reinterpret_cast<SQLPOINTER>(const_cast<char*>(pv->data()));
+      *indPtr = len;
+      buffer_len = len;
+    }
+
+    SQLRETURN rc = SQLBindParameter(hstmt, paramNum, SQL_PARAM_INPUT,
+                                    cType, sqlType, colDef, scale,
+                                    valPtr, buffer_len, indPtr);
+    if (!(rc == SQL_SUCCESS || rc == SQL_SUCCESS_WITH_INFO)) {
+      return rc;
+    }
+  }
+  return SQL_SUCCESS;
+}
+
+// Column-wise parameter arrays for one execute_batch chunk. Each column gets a
+// single C type chosen from its values; the statement's array attributes are
+// restored on destruction so a cached statement can be reused.
+class ParamArrays {
+public:
+  ParamArrays(SQLHSTMT hstmt, std::size_t rows) : hstmt_(hstmt), rows_(rows), status_(rows, SQL_PARAM_UNUSED) {}
+  ~ParamArrays() {
+    if (!attrs_set_) return;
+    SQLSetStmtAttr(hstmt_, SQL_ATTR_PARAMSET_SIZE, reinterpret_cast<SQLPOINTER>(static_cast<SQLULEN>(1)), 0);
+    SQLSetStmtAttr(hstmt_, SQL_ATTR_PARAM_STATUS_PTR, nullptr, 0);
+    SQLSetStmtAttr(hstmt_, SQL_ATTR_PARAMS_PROCESSED_PTR, nullptr, 0);
+  }
+
+  ParamArrays(const ParamArrays&) = delete;
+  ParamArrays& operator=(const ParamArrays&) = delete;
+
+  // Throws std::invalid_argument if a column mixes string and numeric values
+  SQLRETURN bind(std::span<const std::vector<db2::Param>> rows) {
+    const std::size_t ncols = rows.front().size();
+    columns_.resize(ncols);
+    for (std::size_t c = 0; c < ncols; ++c) {
+      SQLRETURN rc = bind_column(rows, c);
+      if (!(rc == SQL_SUCCESS || rc == SQL_SUCCESS_WITH_INFO)) return rc;
+    }
+    attrs_set_ = true;
+    SQLRETURN rc = SQLSetStmtAttr(hstmt_, SQL_ATTR_PARAM_BIND_TYPE, reinterpret_cast<SQLPOINTER>(SQL_PARAM_BIND_BY_COLUMN), 0);
+    if (rc == SQL_SUCCESS || rc == SQL_SUCCESS_WITH_INFO)
+      rc = SQLSetStmtAttr(hstmt_, SQL_ATTR_PARAMSET_SIZE, reinterpret_cast<SQLPOINTER>(static_cast<SQLULEN>(rows_)), 0);
+    if (rc == SQL_SUCCESS || rc == SQL_SUCCESS_WITH_INFO)
+      rc = SQLSetStmtAttr(hstmt_, SQL_ATTR_PARAM_STATUS_PTR, status_.data(), 0);
+    if (rc == SQL_SUCCESS || rc == SQL_SUCCESS_WITH_INFO)
+      rc = SQLSetStmtAttr(hstmt_, SQL_ATTR_PARAMS_PROCESSED_PTR, &processed_, 0);
+    return rc;
+  }
+
+  const std::vector<SQLUSMALLINT>& status() const noexcept { return status_; }
+  std::size_t processed() const noexcept { return static_cast<std::size_t>(processed_); }
+
+private:
+  enum class Kind { Null, Int32, Int64, Double, String };
+
+  struct Column {
+    std::vector<char> data;   // rows_ * width bytes
+    std::vector<SQLLEN> ind;  // rows_ length/indicator values
+  };
+
+  SQLRETURN bind_column(std::span<const std::vector<db2::Param>> rows, std::size_t c) {
+    // Pick one kind per column: integers widen to int64 then double
+    Kind kind = Kind::Null;
+    std::size_t max_len = 1;
+    for (const auto& row : rows) {
+      const auto& v = row[c].value;
+      Kind k = Kind::Null;
+      if (std::holds_alternative<int32_t>(v)) k = Kind::Int32;
+      else if (std::holds_alternative<int64_t>(v)) k = Kind::Int64;
+      else if (std::holds_alternative<double>(v)) k = Kind::Double;
+      else if (std::string_view text; auto pv = param_text(v, text)) { k = Kind::String; max_len = std::max(max_len, pv->size()); }
+      if (k == Kind::Null) continue;
+      if ((k == Kind::String) != (kind == Kind::String) && kind != Kind::Null) {
+        throw std::invalid_argument("execute_batch: parameter " + std::to_string(c + 1) +
+                                    " mixes string and numeric values");
+      }
+      kind = std::max(kind, k);
+    }
+
+    SQLSMALLINT cType = SQL_C_CHAR, sqlType = SQL_VARCHAR;
+    std::size_t width = 1;
+    switch (kind) {
+      case Kind::Int32:  cType = SQL_C_SLONG;   sqlType = SQL_INTEGER; width = sizeof(int32_t); break;
+      case Kind::Int64:  cType = SQL_C_SBIGINT; sqlType = SQL_BIGINT;  width = sizeof(int64_t); break;
+      case Kind::Double: cType = SQL_C_DOUBLE;  sqlType = SQL_DOUBLE;  width = sizeof(double);  break;
+      case Kind::String: width = max_len; break;
+      case Kind::Null:   break;
+    }
+
+    Column& col = columns_[c];
+    col.data.assign(rows_ * width, 0);
+    col.ind.assign(rows_, SQL_NULL_DATA);
+    for (std::size_t r = 0; r < rows_; ++r) {
+      char* at = col.data.data() + r * width;
+      const auto& v = rows[r][c].value;
+      if (std::string_view text; auto pv = param_text(v, text)) {
+        std::memcpy(at, pv->data(), pv->size());
+        col.ind[r] = static_cast<SQLLEN>(pv->size());
+        continue;
+      }
+      // Numeric: widen to the column's C type
+      if (std::holds_alternative<std::nullptr_t>(v)) continue;
+      const int64_t as_i64 = std::holds_alternative<int32_t>(v) ? std::get<int32_t>(v)
+                           : std::holds_alternative<int64_t>(v) ? std::get<int64_t>(v) : 0;
+      if (kind == Kind::Int32) {
+        const int32_t x = std::get<int32_t>(v); std::memcpy(at, &x, sizeof(x));
+      } else if (kind == Kind::Int64) {
+        std::memcpy(at, &as_i64, sizeof(as_i64));
+      } else {
+        const double x = std::holds_alternative<double>(v) ? std::get<double>(v) : static_cast<double>(as_i64);
+        std::memcpy(at, &x, sizeof(x));
+      }
+      col.ind[r] = static_cast<SQLLEN>(width);
+    }
+
+    return SQLBindParameter(hstmt_, static_cast<SQLUSMALLINT>(c + 1), SQL_PARAM_INPUT,
+                            cType, sqlType, static_cast<SQLULEN>(width), 0,
+                            col.data.data(), static_cast<SQLLEN>(width), col.ind.data());
+  }
+
+  SQLHSTMT hstmt_{};
+  std::size_t rows_{0};
+  std::vector<Column> columns_;
+  std::vector<SQLUSMALLINT> status_;
+  SQLULEN processed_{0};
+  bool attrs_set_{false};
+};
+
+// Describe every result column of an executed or prepared statement
+inline SQLRETURN describe_columns(SQLHSTMT hstmt, std::vector<db2::ColumnInfo>& out) {
+  out.clear();
+  SQLSMALLINT ncols = 0;
+  SQLRETURN rc = SQLNumResultCols(hstmt, &ncols);
+  if (!(rc == SQL_SUCCESS || rc == SQL_SUCCESS_WITH_INFO)) return rc;
+  out.resize(ncols > 0 ? static_cast<std::size_t>(ncols) : 0);
+  SQLCHAR name[256];
+  for (SQLSMALLINT i = 0; i < ncols; ++i) {
+    SQLSMALLINT name_len = 0, type = 0, digits = 0, nullable = 0;
+    SQLULEN size = 0;
+    rc = SQLDescribeCol(hstmt, static_cast<SQLUSMALLINT>(i + 1), name, safe_smallint(sizeof(name), "column name buffer"),
+                        &name_len, &type, &size, &digits, &nullable);
+    if (!(rc == SQL_SUCCESS || rc == SQL_SUCCESS_WITH_INFO)) return rc;
+    auto& c = out[static_cast<std::size_t>(i)];
+    // Longer names are truncated to the buffer (DB2 identifiers fit in 128 bytes)
+    const std::size_t len = name_len > 0 ? std::min(static_cast<std::size_t>(name_len), sizeof(name) - 1) : 0;
+    c.name.assign(reinterpret_cast<const char*>(name), len);
+    c.sql_type = type;
+    c.size = static_cast<std::uint64_t>(size);
+    c.decimal_digits = digits;
+    c.nullable = nullable != SQL_NO_NULLS;
+  }
+  return SQL_SUCCESS;
+}
+
+// Widest column (bytes per row) that block fetch binds; wider result sets
+// fall back to row-at-a-time SQLGetData
+constexpr SQLLEN kMaxBlockColumnBytes = 32 * 1024;
+
+// Column-wise bound buffer used by block fetch
+struct BoundColumn {
+  SQLSMALLINT c_type{SQL_C_CHAR};
+  SQLLEN width{0};          // bytes per element (character data includes the terminator)
+  std::vector<char> data;   // rowset_size * width
+  std::vector<SQLLEN> ind;  // rowset_size length/indicator values
+};
+
+// Choose C type and element width for binding a column of the given SQL type
+// (scale `digits`), honoring the caller's preferred representation `hint`.
+// Returns false for columns that cannot be bound to a fixed-size buffer.
+inline bool block_layout(SQLSMALLINT sql_type, SQLULEN size, SQLSMALLINT digits,
+                         db2::ColumnType hint, BoundColumn& out) {
+  // Exact numerics the caller reads as numbers are converted by the driver
+  // instead of being fetched as text and parsed per row
+  const bool exact = (sql_type == SQL_DECIMAL || sql_type == SQL_NUMERIC);
+  if (hint == db2::ColumnType::Real && (exact || sql_type == SQL_DECFLOAT)) {
+    out.c_type = SQL_C_DOUBLE; out.width = sizeof(double); return true;
+  }
+  if (hint == db2::ColumnType::Integer && exact && digits == 0 && size <= 18) {
+    out.c_type = SQL_C_SBIGINT; out.width = sizeof(int64_t); return true;
+  }
+  SQLULEN width = 0;
+  switch (sql_type) {
+    case SQL_SMALLINT: case SQL_INTEGER: case SQL_BIGINT: case SQL_TINYINT: case SQL_BIT:
+      out.c_type = SQL_C_SBIGINT; out.width = sizeof(int64_t); return true;
+    case SQL_REAL: case SQL_FLOAT: case SQL_DOUBLE:
+      out.c_type = SQL_C_DOUBLE; out.width = sizeof(double); return true;
+    case SQL_DECIMAL: case SQL_NUMERIC:
+      width = size + 3; break;                 // sign, decimal point, terminator
+    case SQL_DECFLOAT:
+      width = 43; break;                       // DECFLOAT(34) as text + terminator
+    case SQL_TYPE_DATE: case SQL_TYPE_TIME: case SQL_TYPE_TIMESTAMP:
+      width = 33; break;                       // TIMESTAMP(12) as text + terminator
+    case SQL_CHAR: case SQL_VARCHAR:
+      width = size + 1; break;
+    case SQL_GRAPHIC: case SQL_VARGRAPHIC: case SQL_WCHAR: case SQL_WVARCHAR:
+      width = size * 3 + 1; break;             // double-byte characters converted to multi-byte
+    case SQL_BINARY: case SQL_VARBINARY:
+      if (size == 0 || size > static_cast<SQLULEN>(kMaxBlockColumnBytes)) return false;
+      out.c_type = SQL_C_BINARY;               // raw bytes; rendered as hex text on demand
+      out.width = static_cast<SQLLEN>(size);
+      return true;
+    default:
+      return false;                            // LOB, LONG VARCHAR, XML, ...
+  }
+  if (size == 0 || width > static_cast<SQLULEN>(kMaxBlockColumnBytes)) return false;
+  out.c_type = SQL_C_CHAR;
+  out.width = static_cast<SQLLEN>(width);
+  return true;
+}
+
+[[noreturn]] inline void throw_block_error(int col, const char* what) {
+  throw std::runtime_error("Block fetch column " + std::to_string(col) + ": " + what);
+}
+
+// Character (or binary) data of element `row`; throws if the bound buffer
+// truncated it. SQL_C_CHAR elements reserve one byte for the terminator.
+inline std::string_view bound_text(const BoundColumn& c, std::size_t row, int col) {
+  const SQLLEN len = c.ind[row];
+  const SQLLEN max_len = c.c_type == SQL_C_BINARY ? c.width : c.width - 1;
+  if (len == SQL_NO_TOTAL || len > max_len) throw_block_error(col, "value truncated in bound buffer");
+  return std::string_view(c.data.data() + row * c.width, static_cast<std::size_t>(len));
+}
+
+// Text form of a bound element, matching what SQLGetData(SQL_C_CHAR) returns:
+// numbers are formatted and binary data becomes upper-case hex. Character
+// data is returned as a view into the bound buffer; everything else is
+// written to `scratch`.
+inline std::string_view bound_string(const BoundColumn& c, std::size_t row, int col, std::string& scratch) {
+  const char* at = c.data.data() + row * c.width;
+  switch (c.c_type) {
+    case SQL_C_SBIGINT: {
+      int64_t v; std::memcpy(&v, at, sizeof(v));
+      char buf[24];
+      auto [end, ec] = std::to_chars(buf, buf + sizeof(buf), v);
+      scratch.assign(buf, end);
+      return scratch;
+    }
+    case SQL_C_DOUBLE: {
+      double v; std::memcpy(&v, at, sizeof(v));
+      char buf[32];
+      auto [end, ec] = std::to_chars(buf, buf + sizeof(buf), v);
+      scratch.assign(buf, end);
+      return scratch;
+    }
+    case SQL_C_BINARY: {
+      static constexpr char kHex[] = "0123456789ABCDEF";
+      const std::string_view bytes = bound_text(c, row, col);
+      scratch.resize(bytes.size() * 2);
+      for (std::size_t i = 0; i < bytes.size(); ++i) {
+        const auto b = static_cast<unsigned char>(bytes[i]);
+        scratch[2 * i] = kHex[b >> 4];
+        scratch[2 * i + 1] = kHex[b & 0x0F];
+      }
+      return scratch;
+    }
+    default:
+      return bound_text(c, row, col);
+  }
+}
+
+// Read a column with SQLGetData into `out`, growing it as needed and reusing
+// its capacity across calls. Returns false for NULL (or a column that was
+// already read for this row). For SQL_C_CHAR each chunk is NUL-terminated and
+// the indicator is the remaining length excluding the terminator.
+inline bool get_data_into(SQLHSTMT hstmt, int col, SQLSMALLINT c_type, std::string& out, const char* what) {
+  const std::size_t term = c_type == SQL_C_CHAR ? 1 : 0;
+  out.resize(std::max<std::size_t>(out.capacity(), 256));
+  std::size_t len = 0;
+  for (bool first = true;; first = false) {
+    const std::size_t avail = out.size() - len;
+    SQLLEN ind = 0;
+    SQLRETURN rc = SQLGetData(hstmt, static_cast<SQLUSMALLINT>(col), c_type,
+                              out.data() + len, static_cast<SQLLEN>(avail), &ind);
+    if (rc == SQL_NO_DATA) {
+      if (first) { out.clear(); return false; }
+      break;
+    }
+    if (!(rc == SQL_SUCCESS || rc == SQL_SUCCESS_WITH_INFO)) throw_diag(SQL_HANDLE_STMT, hstmt, what);
+    if (ind == SQL_NULL_DATA) { out.clear(); return false; }
+    if (ind != SQL_NO_TOTAL && static_cast<std::size_t>(ind) <= avail - term) {
+      len += static_cast<std::size_t>(ind); // this chunk completes the value
+      break;
+    }
+    // Truncated (01004): the buffer was filled, more data follows
+    len += avail - term;
+    const std::size_t need = ind == SQL_NO_TOTAL
+        ? out.size() * 2
+        : len + (static_cast<std::size_t>(ind) - (avail - term)) + term;
+    out.resize(std::max(need, len + term + 1));
+  }
+  out.resize(len);
+  return true;
+}
+
+inline std::string_view trim_spaces(std::string_view v) {
+  while (!v.empty() && v.front() == ' ') v.remove_prefix(1);
+  while (!v.empty() && v.back() == ' ') v.remove_suffix(1);
+  return v;
+}
+
+template <class N>
+inline N bound_number(const BoundColumn& c, std::size_t row, int col) {
+  const char* at = c.data.data() + row * c.width;
+  if (c.c_type == SQL_C_SBIGINT) {
+    int64_t v; std::memcpy(&v, at, sizeof(v));
+    return static_cast<N>(v);
+  }
+  if (c.c_type == SQL_C_DOUBLE) {
+    double v; std::memcpy(&v, at, sizeof(v));
+    if constexpr (std::is_integral_v<N>) {
+      // -min() is exactly 2^(bits-1), the first value past max()
+      if (!(v >= static_cast<double>(std::numeric_limits<N>::min()) &&
+            v < -static_cast<double>(std::numeric_limits<N>::min()))) {
+        throw_block_error(col, "numeric value out of range");
+      }
+    }
+    // Integers drop the fraction toward zero, as SQLGetData does (01S07)
+    return static_cast<N>(v);
+  }
+  std::string_view text = trim_spaces(bound_text(c, row, col));
+  N v{};
+  auto [end, ec] = std::from_chars(text.data(), text.data() + text.size(), v);
+  if constexpr (std::is_integral_v<N>) {
+    // DECIMAL text such as "42.50": truncate the fraction like SQLGetData
+    // into an integer does, so block fetch returns the same value
+    if (ec == std::errc{} && end != text.data() + text.size() && *end == '.') {
+      const char* p = end + 1;
+      while (p != text.data() + text.size() && *p >= '0' && *p <= '9') ++p;
+      if (p == text.data() + text.size()) end = p;
+    }
+  }
+  if (ec == std::errc::result_out_of_range) throw_block_error(col, "numeric value out of range");
+  if (ec != std::errc{} || end != text.data() + text.size()) throw_block_error(col, "invalid numeric value");
+  return v;
+}
+
 } // namespace
 
 namespace db2 {
@@ -104,8 +504,351 @@ static inline H load_handle(std::uintptr_t v) {
   }
 }
 
-Connection::Connection() {
-  // Allocate environment
+// Checks out a statement handle for a single execute/query while mtx_ is held.
+// prepare() reuses a cached prepared HSTMT for the SQL text when possible;
+// allocate() returns a plain handle for SQLExecDirect. On release, cached
+// handles are recycled with SQLFreeStmt(SQL_CLOSE/SQL_RESET_PARAMS) and
+// uncached ones are freed.
+class Connection::StatementLease {
+public:
+  explicit StatementLease(Connection& conn) noexcept : conn_(conn), epoch_(conn.conn_epoch_) {}
+  ~StatementLease() { release(); }
+
+  StatementLease(const StatementLease&) = delete;
+  StatementLease& operator=(const StatementLease&) = delete;
+
+  // On failure, diagnostics are on get() when non-null, otherwise on the DBC.
+  SQLRETURN prepare(std::string_view sql) {
+    auto it = conn_.stmt_index_.find(sql);
+    if (it != conn_.stmt_index_.end()) {
+      // Hit: move to the front of the LRU list
+      conn_.stmt_lru_.splice(conn_.stmt_lru_.begin(), conn_.stmt_lru_, it->second);
+      ++conn_.stmt_stats_.hits;
+      activate(load_handle<HSTMT>(it->second->hstmt));
+      cached_ = true;
+      return SQL_SUCCESS;
+    }
+
+    ++conn_.stmt_stats_.misses;
+    SQLRETURN rc = allocate();
+    if (!(rc == SQL_SUCCESS || rc == SQL_SUCCESS_WITH_INFO)) return rc;
+    rc = timed(sql, Instrumentation::Phase::Prepare,
+               [&] { return SQLPrepare(h_, to_sqlchar(sql.data()), safe_integer(sql.size(), "SQL text")); });
+    if (!(rc == SQL_SUCCESS || rc == SQL_SUCCESS_WITH_INFO)) return rc;
+
+    if (conn_.stmt_cache_capacity_ > 0) {
+      conn_.stmt_lru_.push_front(CachedStatement{std::string(sql), store_handle(h_)});
+      conn_.stmt_index_.emplace(conn_.stmt_lru_.front().sql, conn_.stmt_lru_.begin());
+      cached_ = true;
+      conn_.trim_statement_cache_locked(); // evicts from the back, never this entry
+    }
+    return rc;
+  }
+
+  SQLRETURN allocate() {
+    HSTMT h{};
+    SQLRETURN rc = SQLAllocHandle(SQL_HANDLE_STMT, load_handle<HDBC>(conn_.hdbc_), &h);
+    if (!(rc == SQL_SUCCESS || rc == SQL_SUCCESS_WITH_INFO)) return SQL_ERROR;
+    activate(h);
+    return rc;
+  }
+
+  // Per-call SQL_ATTR_QUERY_TIMEOUT in whole seconds, rounded up; <= 0 = none.
+  // Reset when the statement goes back into the cache.
+  SQLRETURN set_timeout(std::chrono::milliseconds timeout) {
+    if (timeout <= std::chrono::milliseconds::zero()) return SQL_SUCCESS;
+    const auto secs = static_cast<SQLULEN>(std::chrono::ceil<std::chrono::seconds>(timeout).count());
+    timeout_set_ = true;
+    return SQLSetStmtAttr(h_, SQL_ATTR_QUERY_TIMEOUT, reinterpret_cast<SQLPOINTER>(secs), 0);
+  }
+
+  HSTMT get() const noexcept { return h_; }
+
+  // Run a query or statement: parameterized SQL goes through the statement
+  // cache, plain SQL through SQLExecDirect. `bound` must outlive execution.
+  SQLRETURN execute(std::string_view sql, const Param* params, int param_count, BoundParams& bound,
+                    std::chrono::milliseconds timeout) {
+    SQLRETURN rc = SQL_SUCCESS;
+    if (params != nullptr && param_count > 0) {
+      rc = prepare(sql);
+      if (!(rc == SQL_SUCCESS || rc == SQL_SUCCESS_WITH_INFO)) return rc;
+      rc = set_timeout(timeout);
+      if (!(rc == SQL_SUCCESS || rc == SQL_SUCCESS_WITH_INFO)) return rc;
+      rc = bind_params(h_, params, param_count, bound);
+      if (!(rc == SQL_SUCCESS || rc == SQL_SUCCESS_WITH_INFO)) return rc;
+      return execute_prepared(sql);
+    }
+    rc = allocate();
+    if (!(rc == SQL_SUCCESS || rc == SQL_SUCCESS_WITH_INFO)) return rc;
+    rc = set_timeout(timeout);
+    if (!(rc == SQL_SUCCESS || rc == SQL_SUCCESS_WITH_INFO)) return rc;
+    return execute_direct(sql);
+  }
+
+  // SQLExecute of the prepared `sql` / SQLExecDirect of `sql` on get(),
+  // timed for the connection's instrumentation
+  SQLRETURN execute_prepared(std::string_view sql) {
+    return timed(sql, Instrumentation::Phase::Execute, [&] { return SQLExecute(h_); });
+  }
+
+  SQLRETURN execute_direct(std::string_view sql) {
+    return timed(sql, Instrumentation::Phase::Execute,
+                 [&] { return SQLExecDirect(h_, to_sqlchar(sql.data()), safe_integer(sql.size(), "SQL text")); });
+  }
+
+  void release() noexcept {
+    if (!h_) return;
+    HSTMT h = h_;
+    h_ = 0;
+    {
+      std::scoped_lock lk(conn_.cancel_mtx_);
+      if (conn_.active_stmt_ == store_handle(h)) conn_.active_stmt_ = 0;
+    }
+    // A reconnect in between already released every handle of the old DBC
+    if (epoch_ != conn_.conn_epoch_) return;
+
+    if (cached_) {
+      SQLRETURN rc_timeout = SQL_SUCCESS;
+      if (timeout_set_) {
+        rc_timeout = SQLSetStmtAttr(h, SQL_ATTR_QUERY_TIMEOUT, reinterpret_cast<SQLPOINTER>(static_cast<SQLULEN>(0)), 0);
+      }
+      SQLRETURN rc_close = SQLFreeStmt(h, SQL_CLOSE);
+      SQLRETURN rc_reset = SQLFreeStmt(h, SQL_RESET_PARAMS);
+      if ((rc_timeout == SQL_SUCCESS || rc_timeout == SQL_SUCCESS_WITH_INFO) &&
+          (rc_close == SQL_SUCCESS || rc_close == SQL_SUCCESS_WITH_INFO) &&
+          (rc_reset == SQL_SUCCESS || rc_reset == SQL_SUCCESS_WITH_INFO)) {
+        return; // back in the cache, ready for reuse
+      }
+      // Statement could not be reset: drop it from the cache
+      const auto key = store_handle(h);
+      for (auto it = conn_.stmt_lru_.begin(); it != conn_.stmt_lru_.end(); ++it) {
+        if (it->hstmt == key) {
+          conn_.stmt_index_.erase(it->sql);
+          conn_.stmt_lru_.erase(it);
+          break;
+        }
+      }
+    }
+    SQLCloseCursor(h);
+    SQLFreeHandle(SQL_HANDLE_STMT, h);
+  }
+
+private:
+  template <class Call>
+  SQLRETURN timed(std::string_view sql, Instrumentation::Phase phase, Call&& call) {
+    Instrumentation* instr = conn_.instr_.get();
+    if (!instr) return call();
+    const auto start = std::chrono::steady_clock::now();
+    const SQLRETURN rc = call();
+    instr->on_phase(sql, phase, std::chrono::steady_clock::now() - start, 0);
+    return rc;
+  }
+
+  // Take ownership of `h` and publish it for Connection::cancel()
+  void activate(HSTMT h) {
+    h_ = h;
+    std::scoped_lock lk(conn_.cancel_mtx_);
+    conn_.active_stmt_ = store_handle(h);
+  }
+
+  Connection& conn_;
+  std::uint64_t epoch_{0};
+  HSTMT h_{};
+  bool cached_{false};
+  bool timeout_set_{false};
+};
+
+// Fetch state of an executed statement. In block mode the result columns are
+// bound to column-wise arrays and each SQLFetch returns up to rowset_size rows
+// that Row getters read directly; otherwise rows are fetched one at a time and
+// Row getters call SQLGetData.
+class Connection::ResultSet {
+public:
+  // `desc` is the statement's known column metadata, if any (see describe())
+  explicit ResultSet(HSTMT h, std::shared_ptr<const ResultDescriptor> desc = nullptr) noexcept
+      : hstmt_(h), desc_(std::move(desc)) {}
+  ~ResultSet() {
+    if (instr_ && fetch_calls_ > 0) instr_->on_phase(sql_, Instrumentation::Phase::Fetch, fetch_time_, fetched_rows_);
+    unbind();
+  }
+
+  // Report fetch time, rows and fetch errors for `sql` to `instr` (if any).
+  // The SQL text is copied since a cursor may outlive the caller's string.
+  void instrument(const std::shared_ptr<Instrumentation>& instr, std::string_view sql) {
+    if (!instr) return;
+    sql_.assign(sql);
+    instr_ = instr;
+  }
+
+  ResultSet(const ResultSet&) = delete;
+  ResultSet& operator=(const ResultSet&) = delete;
+
+  // Bind columns for block fetch when rowset_size > 1 and every column has a
+  // bounded width; otherwise stay in row-at-a-time mode. `types` optionally
+  // gives the representation the caller will read each column as.
+  SQLRETURN open(std::size_t rowset_size, std::span<const ColumnType> types = {}) {
+    if (rowset_size <= 1) return SQL_SUCCESS;
+    SQLSMALLINT ncols = 0;
+    SQLRETURN rc = SQLNumResultCols(hstmt_, &ncols);
+    if (!(rc == SQL_SUCCESS || rc == SQL_SUCCESS_WITH_INFO)) return rc;
+    if (ncols <= 0) return SQL_SUCCESS;
+    // Binding needs the column types: describe now unless known (and still
+    // matching) from an earlier describe()
+    if (!desc_ || desc_->size() != static_cast<std::size_t>(ncols)) {
+      desc_.reset();
+      rc = describe();
+      if (!(rc == SQL_SUCCESS || rc == SQL_SUCCESS_WITH_INFO)) return rc;
+    }
+
+    std::vector<BoundColumn> cols(static_cast<std::size_t>(ncols));
+    for (SQLSMALLINT i = 0; i < ncols; ++i) {
+      const auto& info = desc_->columns()[static_cast<std::size_t>(i)];
+      const auto hint = static_cast<std::size_t>(i) < types.size() ? types[i] : ColumnType::Any;
+      if (!block_layout(info.sql_type, static_cast<SQLULEN>(info.size), info.decimal_digits, hint, cols[i])) {
+        return SQL_SUCCESS; // row-at-a-time fallback
+      }
+    }
+
+    bound_ = true; // from here on unbind() must restore the statement
+    for (SQLSMALLINT i = 0; i < ncols; ++i) {
+      auto& c = cols[i];
+      c.data.resize(rowset_size * static_cast<std::size_t>(c.width));
+      c.ind.resize(rowset_size);
+      rc = SQLBindCol(hstmt_, static_cast<SQLUSMALLINT>(i + 1), c.c_type, c.data.data(), c.width, c.ind.data());
+      if (!(rc == SQL_SUCCESS || rc == SQL_SUCCESS_WITH_INFO)) return rc;
+    }
+    status_.resize(rowset_size);
+    rc = SQLSetStmtAttr(hstmt_, SQL_ATTR_ROW_BIND_TYPE, reinterpret_cast<SQLPOINTER>(SQL_BIND_BY_COLUMN), 0);
+    if (rc == SQL_SUCCESS || rc == SQL_SUCCESS_WITH_INFO)
+      rc = SQLSetStmtAttr(hstmt_, SQL_ATTR_ROW_ARRAY_SIZE, reinterpret_cast<SQLPOINTER>(static_cast<SQLULEN>(rowset_size)), 0);
+    if (rc == SQL_SUCCESS || rc == SQL_SUCCESS_WITH_INFO)
+      rc = SQLSetStmtAttr(hstmt_, SQL_ATTR_ROW_STATUS_PTR, status_.data(), 0);
+    if (rc == SQL_SUCCESS || rc == SQL_SUCCESS_WITH_INFO)
+      rc = SQLSetStmtAttr(hstmt_, SQL_ATTR_ROWS_FETCHED_PTR, &fetched_, 0);
+    if (!(rc == SQL_SUCCESS || rc == SQL_SUCCESS_WITH_INFO)) return rc;
+    columns_ = std::move(cols);
+    return SQL_SUCCESS;
+  }
+
+  // Column metadata, described on first use and kept for this execution
+  const ResultDescriptor& descriptor() const { return *shared_descriptor(); }
+
+  const std::shared_ptr<const ResultDescriptor>& shared_descriptor() const {
+    if (!desc_) {
+      SQLRETURN rc = describe();
+      if (!(rc == SQL_SUCCESS || rc == SQL_SUCCESS_WITH_INFO)) {
+        throw_diag(SQL_HANDLE_STMT, hstmt_, "SQLDescribeCol failed");
+      }
+    }
+    return desc_;
+  }
+
+  // Fetch the next row (or rowset). Returns SQL_NO_DATA at the end.
+  SQLRETURN fetch() {
+    if (!instr_) return fetch_rows();
+    const auto start = std::chrono::steady_clock::now();
+    const SQLRETURN rc = fetch_rows();
+    fetch_time_ += std::chrono::steady_clock::now() - start;
+    fetched_rows_ += rows_;
+    ++fetch_calls_;
+    return rc;
+  }
+
+  // Report a failure of this result set's statement to the instrumentation
+  void note_error(const Error& err) const noexcept {
+    if (instr_) instr_->on_error(sql_, err.sqlstate());
+  }
+
+  HSTMT hstmt() const noexcept { return hstmt_; }
+  bool block() const noexcept { return !columns_.empty(); }
+  std::size_t rows() const noexcept { return rows_; }
+
+  // Per-column buffer reused across rows for values that cannot be viewed in
+  // place (row-at-a-time data, formatted numbers, hex)
+  std::string& scratch(int col) const {
+    if (col < 1) throw std::out_of_range("Column index out of range: " + std::to_string(col));
+    if (scratch_.size() < static_cast<std::size_t>(col)) scratch_.resize(static_cast<std::size_t>(col));
+    return scratch_[static_cast<std::size_t>(col - 1)];
+  }
+
+  const BoundColumn& column(int col) const {
+    if (col < 1 || static_cast<std::size_t>(col) > columns_.size()) {
+      throw std::out_of_range("Block fetch column index out of range: " + std::to_string(col));
+    }
+    return columns_[static_cast<std::size_t>(col - 1)];
+  }
+
+private:
+  SQLRETURN fetch_rows() {
+    rows_ = 0;
+    SQLRETURN rc = SQLFetch(hstmt_);
+    if (!(rc == SQL_SUCCESS || rc == SQL_SUCCESS_WITH_INFO)) return rc;
+    if (!block()) {
+      rows_ = 1;
+      return rc;
+    }
+    rows_ = static_cast<std::size_t>(fetched_);
+    for (std::size_t i = 0; i < rows_; ++i) {
+      if (status_[i] == SQL_ROW_ERROR) return SQL_ERROR;
+    }
+    return rc;
+  }
+
+  // Restore row-at-a-time defaults so a cached statement can be reused
+  void unbind() noexcept {
+    if (!bound_) return;
+    SQLFreeStmt(hstmt_, SQL_UNBIND);
+    SQLSetStmtAttr(hstmt_, SQL_ATTR_ROW_ARRAY_SIZE, reinterpret_cast<SQLPOINTER>(static_cast<SQLULEN>(1)), 0);
+    SQLSetStmtAttr(hstmt_, SQL_ATTR_ROW_STATUS_PTR, nullptr, 0);
+    SQLSetStmtAttr(hstmt_, SQL_ATTR_ROWS_FETCHED_PTR, nullptr, 0);
+    bound_ = false;
+  }
+
+  SQLRETURN describe() const {
+    std::vector<ColumnInfo> cols;
+    SQLRETURN rc = describe_columns(hstmt_, cols);
+    if (rc == SQL_SUCCESS || rc == SQL_SUCCESS_WITH_INFO) {
+      desc_ = std::make_shared<const ResultDescriptor>(std::move(cols));
+    }
+    return rc;
+  }
+
+  HSTMT hstmt_{};
+  mutable std::shared_ptr<const ResultDescriptor> desc_;
+  bool bound_{false};
+  std::vector<BoundColumn> columns_;
+  std::vector<SQLUSMALLINT> status_;
+  SQLULEN fetched_{0};
+  std::size_t rows_{0};
+  mutable std::vector<std::string> scratch_;
+
+  // Instrumentation (only set when the connection has some)
+  std::shared_ptr<Instrumentation> instr_;
+  std::string sql_;
+  std::chrono::nanoseconds fetch_time_{0};
+  std::uint64_t fetched_rows_{0};
+  std::uint64_t fetch_calls_{0};
+};
+
+namespace {
+std::mutex g_env_mtx;                 // guards g_env and the ENV handle's lifetime
+std::weak_ptr<Environment> g_env;
+} // namespace
+
+std::shared_ptr<Environment> Environment::shared() {
+  std::scoped_lock lk(g_env_mtx);
+  if (auto env = g_env.lock()) return env;
+  // The deleter takes g_env_mtx so a new environment is never allocated
+  // while the previous one is still being freed.
+  std::shared_ptr<Environment> env(new Environment(), [](Environment* e) {
+    std::scoped_lock del_lk(g_env_mtx);
+    delete e;
+  });
+  g_env = env;
+  return env;
+}
+
+Environment::Environment() {
   HENV henv{};
   SQLRETURN rc = SQLAllocHandle(SQL_HANDLE_ENV, SQL_NULL_HANDLE, &henv);
   if (!(rc == SQL_SUCCESS || rc == SQL_SUCCESS_WITH_INFO)) {
@@ -115,21 +858,146 @@ Connection::Connection() {
   // Set ODBC version 3
   rc = SQLSetEnvAttr(henv, SQL_ATTR_ODBC_VERSION, reinterpret_cast<SQLPOINTER>(SQL_OV_ODBC3), 0);
   if (!(rc == SQL_SUCCESS || rc == SQL_SUCCESS_WITH_INFO)) {
-    std::string msg = diag_message(SQL_HANDLE_ENV, henv);
+    auto err = diag_error("Failed to set ODBC version", SQL_HANDLE_ENV, henv);
     SQLFreeHandle(SQL_HANDLE_ENV, henv);
-    throw std::runtime_error("Failed to set ODBC version: " + msg);
+    throw err;
   }
+  henv_ = store_handle(henv);
+}
+
+Environment::~Environment() noexcept {
+  if (henv_ != 0) SQLFreeHandle(SQL_HANDLE_ENV, load_handle<HENV>(henv_));
+}
+
+// ---------------- Error ----------------
+
+Error::Error(const char* context, std::vector<Diagnostic> records) : std::runtime_error(context) {
+  auto data = std::make_shared<Data>();
+  data->records = std::move(records);
+  data_ = std::move(data);
+}
 
-  // Allocate connection
+const char* Error::what() const noexcept {
+  try {
+    std::call_once(data_->formatted, [this] {
+      // "<context>: [SQLSTATE] (native) message | ..."
+      std::string text = context();
+      text += ": ";
+      if (data_->records.empty()) text += "DB2 CLI error (no diagnostics)";
+      for (std::size_t i = 0; i < data_->records.size(); ++i) {
+        const auto& rec = data_->records[i];
+        if (i > 0) text += " | ";
+        text += '[';
+        text += rec.sqlstate;
+        text += "] (";
+        text += std::to_string(rec.native_error);
+        text += ") ";
+        text += rec.message;
+      }
+      data_->text = std::move(text);
+    });
+    return data_->text.c_str();
+  } catch (...) {
+    return context(); // formatting failed (out of memory)
+  }
+}
+
+std::string_view Error::sqlstate() const noexcept {
+  return data_->records.empty() ? std::string_view{} : std::string_view(data_->records.front().sqlstate);
+}
+
+std::int32_t Error::native_error() const noexcept {
+  return data_->records.empty() ? 0 : data_->records.front().native_error;
+}
+
+// ---------------- Circuit breaker ----------------
+
+namespace {
+std::mutex g_breakers_mtx;
+std::unordered_map<std::string, std::weak_ptr<CircuitBreaker>> g_breakers;
+} // namespace
+
+CircuitBreaker::CircuitBreaker(Options options) : options_(options) {}
+
+std::shared_ptr<CircuitBreaker> CircuitBreaker::for_target(std::string_view target) {
+  std::scoped_lock lk(g_breakers_mtx);
+  std::string key(target);
+  if (auto it = g_breakers.find(key); it != g_breakers.end()) {
+    if (auto breaker = it->second.lock()) return breaker;
+  }
+  std::erase_if(g_breakers, [](const auto& entry) { return entry.second.expired(); });
+  auto breaker = std::make_shared<CircuitBreaker>();
+  g_breakers[std::move(key)] = breaker;
+  return breaker;
+}
+
+bool CircuitBreaker::enter(bool recovering) {
+  std::unique_lock lk(mtx_);
+  switch (state_) {
+    case State::Closed:
+      // The first caller to see a lost link probes; others queue behind it
+      if (recovering) state_ = State::Probing;
+      return true;
+    case State::Open:
+      if (std::chrono::steady_clock::now() < retry_at_) return false; // fail fast
+      state_ = State::Probing;
+      return true;
+    case State::Probing:
+    default:
+      if (options_.probe_wait <= std::chrono::milliseconds::zero()) return false;
+      cv_.wait_for(lk, options_.probe_wait, [&] { return state_ != State::Probing; });
+      return state_ == State::Closed; // the probe got through: reconnect too
+  }
+}
+
+void CircuitBreaker::leave(bool reachable) {
+  {
+    std::scoped_lock lk(mtx_);
+    if (reachable) {
+      state_ = State::Closed;
+      failures_ = 0;
+    } else {
+      ++failures_;
+      state_ = State::Open;
+      retry_at_ = std::chrono::steady_clock::now() + next_backoff_locked();
+    }
+  }
+  cv_.notify_all();
+}
+
+CircuitBreaker::State CircuitBreaker::state() const {
+  std::scoped_lock lk(mtx_);
+  return state_;
+}
+
+std::uint32_t CircuitBreaker::consecutive_failures() const {
+  std::scoped_lock lk(mtx_);
+  return failures_;
+}
+
+std::chrono::milliseconds CircuitBreaker::next_backoff_locked() {
+  // initial * multiplier^(failures - 1), capped, then jittered so that
+  // processes that lost the server together do not retry in lockstep
+  double backoff = static_cast<double>(options_.initial_backoff.count());
+  const double cap = static_cast<double>(options_.max_backoff.count());
+  for (std::uint32_t i = 1; i < failures_ && backoff < cap; ++i) backoff *= options_.multiplier;
+  backoff = std::min(backoff, cap);
+  if (options_.jitter > 0) {
+    thread_local std::mt19937 gen{std::random_device{}()};
+    std::uniform_real_distribution<double> dist(-options_.jitter, options_.jitter);
+    backoff *= 1.0 + dist(gen);
+  }
+  return std::chrono::milliseconds(static_cast<std::int64_t>(std::max(backoff, 0.0)));
+}
+
+Connection::Connection() : env_(Environment::shared()) {
+  // Allocate connection from the shared environment
+  auto henv = load_handle<HENV>(env_->handle());
   HDBC hdbc{};
-  rc = SQLAllocHandle(SQL_HANDLE_DBC, henv, &hdbc);
+  SQLRETURN rc = SQLAllocHandle(SQL_HANDLE_DBC, henv, &hdbc);
   if (!(rc == SQL_SUCCESS || rc == SQL_SUCCESS_WITH_INFO)) {
-    std::string msg = diag_message(SQL_HANDLE_ENV, henv);
-    SQLFreeHandle(SQL_HANDLE_ENV, henv);
-    throw std::runtime_error("Failed to allocate DB2 connection handle: " + msg);
+    throw_diag(SQL_HANDLE_ENV, henv, "Failed to allocate DB2 connection handle");
   }
-
-  henv_ = store_handle(henv);
   hdbc_ = store_handle(hdbc);
 }
 
@@ -140,17 +1008,28 @@ Connection::~Connection() noexcept {
 
 Connection::Connection(Connection&& other) noexcept {
   std::scoped_lock lk(other.mtx_);
-  henv_ = other.henv_;
+  env_ = std::move(other.env_);
   hdbc_ = other.hdbc_;
-  connected_ = other.connected_;
+  link_ = other.link_;
+  breaker_ = std::move(other.breaker_);
+  instr_ = std::move(other.instr_);
   mode_ = other.mode_;
   dsn_ = std::move(other.dsn_);
   uid_ = std::move(other.uid_);
   pwd_ = std::move(other.pwd_);
   conn_str_ = std::move(other.conn_str_);
-  other.henv_ = 0;
+  stmt_lru_ = std::move(other.stmt_lru_);     // list nodes (and views into them) stay valid
+  stmt_index_ = std::move(other.stmt_index_);
+  stmt_cache_capacity_ = other.stmt_cache_capacity_;
+  stmt_stats_ = other.stmt_stats_;
+  conn_epoch_ = other.conn_epoch_;
+  in_txn_ = other.in_txn_;
+  describe_cache_ = std::move(other.describe_cache_);
+  other.stmt_lru_.clear();
+  other.stmt_index_.clear();
   other.hdbc_ = 0;
-  other.connected_ = false;
+  other.link_ = LinkState::Disconnected;
+  other.in_txn_ = false;
   other.mode_ = ConnMode::None;
 }
 
@@ -158,201 +1037,400 @@ Connection& Connection::operator=(Connection&& other) noexcept {
   if (this == &other) return *this;
   std::scoped_lock lk(mtx_, other.mtx_);
   cleanup_locked();
-  henv_ = other.henv_;
+  env_ = std::move(other.env_);
   hdbc_ = other.hdbc_;
-  connected_ = other.connected_;
+  link_ = other.link_;
+  breaker_ = std::move(other.breaker_);
+  instr_ = std::move(other.instr_);
   mode_ = other.mode_;
   dsn_ = std::move(other.dsn_);
   uid_ = std::move(other.uid_);
   pwd_ = std::move(other.pwd_);
   conn_str_ = std::move(other.conn_str_);
-  other.henv_ = 0;
+  stmt_lru_ = std::move(other.stmt_lru_);     // list nodes (and views into them) stay valid
+  stmt_index_ = std::move(other.stmt_index_);
+  stmt_cache_capacity_ = other.stmt_cache_capacity_;
+  stmt_stats_ = other.stmt_stats_;
+  conn_epoch_ = other.conn_epoch_;
+  in_txn_ = other.in_txn_;
+  describe_cache_ = std::move(other.describe_cache_);
+  other.stmt_lru_.clear();
+  other.stmt_index_.clear();
   other.hdbc_ = 0;
-  other.connected_ = false;
+  other.link_ = LinkState::Disconnected;
+  other.in_txn_ = false;
   other.mode_ = ConnMode::None;
   return *this;
 }
 
+bool Connection::cancel() noexcept {
+  // Statements are unpublished under cancel_mtx_ before they are freed (by
+  // their lease, or by drop_link_locked on reconnect), so holding it keeps
+  // the handle alive while SQLCancel runs
+  std::scoped_lock lk(cancel_mtx_);
+  if (active_stmt_ == 0) return false;
+  SQLRETURN rc = SQLCancel(load_handle<HSTMT>(active_stmt_));
+  return rc == SQL_SUCCESS || rc == SQL_SUCCESS_WITH_INFO;
+}
+
+void Connection::begin() {
+  std::scoped_lock lk(mtx_);
+  ensure_connected_locked();
+  if (in_txn_) throw std::logic_error("DB2 transaction already in progress");
+  auto hdbc = load_handle<HDBC>(hdbc_);
+  SQLRETURN rc = SQLSetConnectAttr(hdbc, SQL_ATTR_AUTOCOMMIT,
+                                   reinterpret_cast<SQLPOINTER>(SQL_AUTOCOMMIT_OFF), 0);
+  if (rc != SQL_SUCCESS && rc != SQL_SUCCESS_WITH_INFO) {
+    throw_diag(SQL_HANDLE_DBC, hdbc, "SQLSetConnectAttr(SQL_ATTR_AUTOCOMMIT)");
+  }
+  in_txn_ = true;
+}
+
+void Connection::commit() {
+  std::scoped_lock lk(mtx_);
+  if (!in_txn_) throw std::logic_error("DB2 commit without an active transaction");
+  auto hdbc = load_handle<HDBC>(hdbc_);
+  SQLRETURN rc = SQLEndTran(SQL_HANDLE_DBC, hdbc, SQL_COMMIT);
+  if (rc != SQL_SUCCESS && rc != SQL_SUCCESS_WITH_INFO) {
+    // Read the diagnostics before restoring autocommit resets them
+    auto err = diag_error("SQLEndTran(SQL_COMMIT)", SQL_HANDLE_DBC, hdbc);
+    end_transaction_locked(false);
+    throw err;
+  }
+  end_transaction_locked(true);
+}
+
+bool Connection::rollback() noexcept {
+  std::scoped_lock lk(mtx_);
+  if (!in_txn_) return false;
+  return end_transaction_locked(false);
+}
+
+bool Connection::in_transaction() const noexcept {
+  std::scoped_lock lk(mtx_);
+  return in_txn_;
+}
+
+bool Connection::end_transaction_locked(bool commit) noexcept {
+  // Assumes mtx_ is held and in_txn_ is set. After a successful commit only
+  // autocommit needs restoring; otherwise roll back (harmless if the commit
+  // already failed).
+  auto hdbc = load_handle<HDBC>(hdbc_);
+  SQLRETURN rc = commit ? SQL_SUCCESS : SQLEndTran(SQL_HANDLE_DBC, hdbc, SQL_ROLLBACK);
+  const bool ok = rc == SQL_SUCCESS || rc == SQL_SUCCESS_WITH_INFO;
+  const bool broken = !ok && is_connection_broken_sqlstate(first_sql_state(SQL_HANDLE_DBC, hdbc));
+  SQLSetConnectAttr(hdbc, SQL_ATTR_AUTOCOMMIT, reinterpret_cast<SQLPOINTER>(SQL_AUTOCOMMIT_ON), 0);
+  in_txn_ = false;
+  // The server discards the unit of work with the link; reconnect now that
+  // no transaction is pending, so the next begin() starts on a live one
+  if (broken) try_reconnect_locked();
+  return ok;
+}
+
 bool Connection::is_connected() const noexcept {
   std::scoped_lock lk(mtx_);
-  return connected_;
+  return link_ == LinkState::Connected;
+}
+
+void Connection::set_statement_cache_capacity(std::size_t capacity) {
+  std::scoped_lock lk(mtx_);
+  stmt_cache_capacity_ = capacity;
+  trim_statement_cache_locked();
+}
+
+StatementCacheStats Connection::statement_cache_stats() const {
+  std::scoped_lock lk(mtx_);
+  StatementCacheStats out = stmt_stats_;
+  out.size = stmt_lru_.size();
+  out.capacity = stmt_cache_capacity_;
+  return out;
+}
+
+std::shared_ptr<const ResultDescriptor> Connection::describe(std::string_view sql) {
+  std::scoped_lock lk(mtx_);
+  ensure_connected_locked();
+  if (auto desc = cached_descriptor_locked(sql)) return desc;
+
+  for (int attempts = 0;; ++attempts) {
+    std::optional<Error> err;
+    {
+      // Prepared through the statement cache, so a following execute of the
+      // same SQL does not prepare it again
+      StatementLease stmt(*this);
+      std::vector<ColumnInfo> cols;
+      SQLRETURN rc = stmt.prepare(sql);
+      if (rc == SQL_SUCCESS || rc == SQL_SUCCESS_WITH_INFO) rc = describe_columns(stmt.get(), cols);
+      if (rc == SQL_SUCCESS || rc == SQL_SUCCESS_WITH_INFO) {
+        auto desc = std::make_shared<const ResultDescriptor>(std::move(cols));
+        describe_cache_.emplace(std::string(sql), desc);
+        return desc;
+      }
+      err = stmt.get() != HSTMT{} ? diag_error("describe failed", SQL_HANDLE_STMT, stmt.get())
+                                  : diag_error("describe failed", SQL_HANDLE_DBC, load_handle<HDBC>(hdbc_));
+      note_error_locked(sql, *err);
+    } // statement released before reconnecting
+    if (attempts == 0 && is_connection_broken_sqlstate(err->sqlstate()) && try_reconnect_locked()) continue;
+    throw *err;
+  }
+}
+
+std::shared_ptr<const ResultDescriptor> Connection::cached_descriptor_locked(std::string_view sql) const {
+  if (describe_cache_.empty()) return nullptr;
+  auto it = describe_cache_.find(sql);
+  return it != describe_cache_.end() ? it->second : nullptr;
+}
+
+void Connection::trim_statement_cache_locked() noexcept {
+  while (stmt_lru_.size() > stmt_cache_capacity_) {
+    auto& victim = stmt_lru_.back();
+    stmt_index_.erase(victim.sql);
+    SQLFreeHandle(SQL_HANDLE_STMT, load_handle<HSTMT>(victim.hstmt));
+    stmt_lru_.pop_back();
+    ++stmt_stats_.evictions;
+  }
+}
+
+void Connection::clear_statement_cache_locked() noexcept {
+  for (auto& entry : stmt_lru_) {
+    SQLFreeHandle(SQL_HANDLE_STMT, load_handle<HSTMT>(entry.hstmt));
+  }
+  stmt_index_.clear();
+  stmt_lru_.clear();
+  describe_cache_.clear(); // the schema may have changed while disconnected
 }
 
 void Connection::ensure_connected_locked() {
-  if (!connected_) {
-    throw std::runtime_error("DB2 connection is not established");
+  switch (link_) {
+    case LinkState::Connected:
+      return;
+    case LinkState::Broken:
+      // Lost earlier and not yet restored: try again (or fail fast)
+      if (reconnect_locked()) return;
+      throw std::runtime_error("DB2 connection lost and reconnect failed (database unavailable)");
+    case LinkState::Disconnected:
+    default:
+      throw std::runtime_error("DB2 connection is not established");
   }
 }
 
 void Connection::connect_with_dsn(std::string_view dsn, std::string_view uid, std::string_view pwd) {
   std::scoped_lock lk(mtx_);
-  if (connected_) return; // already connected
-  auto hdbc = load_handle<HDBC>(hdbc_);
-  // Use SQL_NTS to avoid length narrowing, ensure null-terminated buffers
-  std::string dsn_s(dsn);
-  std::string uid_s(uid);
-  std::string pwd_s(pwd);
-  SQLRETURN rc = SQLConnect(
-      hdbc,
-      to_sqlchar(dsn_s.c_str()), SQL_NTS,
-      to_sqlchar(uid_s.c_str()), SQL_NTS,
-      to_sqlchar(pwd_s.c_str()), SQL_NTS);
-  if (!(rc == SQL_SUCCESS || rc == SQL_SUCCESS_WITH_INFO)) {
-    throw_diag(SQL_HANDLE_DBC, hdbc, "SQLConnect");
-  }
-  connected_ = true;
-  // Store for potential auto-reconnect
+  if (link_ == LinkState::Connected) return; // already connected
+  if (link_ == LinkState::Broken) drop_link_locked();
+  // Stored for auto-reconnect; null-terminated for SQL_NTS
   mode_ = ConnMode::Dsn;
   dsn_.assign(dsn.begin(), dsn.end());
   uid_.assign(uid.begin(), uid.end());
   pwd_.assign(pwd.begin(), pwd.end());
   conn_str_.clear();
+  if (!breaker_) breaker_ = CircuitBreaker::for_target("DSN=" + dsn_);
+  if (!breaker_->enter(false)) {
+    throw std::runtime_error("SQLConnect: database unavailable (circuit breaker open), failing fast");
+  }
+  SQLRETURN rc = connect_stored_locked();
+  if (!(rc == SQL_SUCCESS || rc == SQL_SUCCESS_WITH_INFO)) {
+    auto err = diag_error("SQLConnect", SQL_HANDLE_DBC, load_handle<HDBC>(hdbc_));
+    breaker_->leave(!is_connection_broken_sqlstate(err.sqlstate()));
+    throw err;
+  }
+  breaker_->leave(true);
+  link_ = LinkState::Connected;
 }
 
 void Connection::connect_with_conn_str(std::string_view conn_str) {
   std::scoped_lock lk(mtx_);
-  if (connected_) return;
-  auto hdbc = load_handle<HDBC>(hdbc_);
-  SQLCHAR outConn[1024];
-  SQLSMALLINT outLen = 0;
-  std::string cs(conn_str);
-  SQLRETURN rc = SQLDriverConnect(
-      hdbc, nullptr,
-      to_sqlchar(cs.c_str()), SQL_NTS,
-      outConn, safe_smallint(sizeof(outConn), "SQLDriverConnect out buffer"), &outLen,
-      SQL_DRIVER_NOPROMPT);
-  if (!(rc == SQL_SUCCESS || rc == SQL_SUCCESS_WITH_INFO)) {
-    throw_diag(SQL_HANDLE_DBC, hdbc, "SQLDriverConnect");
-  }
-  connected_ = true;
-  // Store for potential auto-reconnect
+  if (link_ == LinkState::Connected) return;
+  if (link_ == LinkState::Broken) drop_link_locked();
+  // Stored for auto-reconnect
   mode_ = ConnMode::ConnStr;
   conn_str_.assign(conn_str.begin(), conn_str.end());
   dsn_.clear(); uid_.clear(); pwd_.clear();
+  if (!breaker_) breaker_ = CircuitBreaker::for_target(conn_str_);
+  if (!breaker_->enter(false)) {
+    throw std::runtime_error("SQLDriverConnect: database unavailable (circuit breaker open), failing fast");
+  }
+  SQLRETURN rc = connect_stored_locked();
+  if (!(rc == SQL_SUCCESS || rc == SQL_SUCCESS_WITH_INFO)) {
+    auto err = diag_error("SQLDriverConnect", SQL_HANDLE_DBC, load_handle<HDBC>(hdbc_));
+    breaker_->leave(!is_connection_broken_sqlstate(err.sqlstate()));
+    throw err;
+  }
+  breaker_->leave(true);
+  link_ = LinkState::Connected;
+}
+
+void Connection::set_circuit_breaker(std::shared_ptr<CircuitBreaker> breaker) {
+  std::scoped_lock lk(mtx_);
+  breaker_ = std::move(breaker);
+}
+
+std::shared_ptr<CircuitBreaker> Connection::circuit_breaker() const {
+  std::scoped_lock lk(mtx_);
+  return breaker_;
+}
+
+void Connection::set_instrumentation(std::shared_ptr<Instrumentation> instrumentation) {
+  std::scoped_lock lk(mtx_);
+  instr_ = std::move(instrumentation);
+}
+
+std::shared_ptr<Instrumentation> Connection::instrumentation() const {
+  std::scoped_lock lk(mtx_);
+  return instr_;
+}
+
+void Connection::note_error_locked(std::string_view sql, const Error& err) const noexcept {
+  if (instr_) instr_->on_error(sql, err.sqlstate());
 }
 
 void Connection::disconnect() noexcept {
   std::scoped_lock lk(mtx_);
-  if (connected_ && hdbc_ != 0) {
-    SQLDisconnect(load_handle<HDBC>(hdbc_));
-    connected_ = false;
+  if (hdbc_ == 0) return;
+  if (link_ == LinkState::Connected) {
+    if (in_txn_) end_transaction_locked(false); // SQLDisconnect refuses an open unit of work
+    drop_link_locked();
   }
+  link_ = LinkState::Disconnected;
 }
 
 void Connection::cleanup_locked() noexcept {
   if (hdbc_ != 0) {
-    if (connected_) {
-      SQLDisconnect(load_handle<HDBC>(hdbc_));
-      connected_ = false;
+    if (link_ == LinkState::Connected) {
+      if (in_txn_) end_transaction_locked(false);
+      drop_link_locked();
     }
+    link_ = LinkState::Disconnected;
     SQLFreeHandle(SQL_HANDLE_DBC, load_handle<HDBC>(hdbc_));
     hdbc_ = 0;
   }
-  if (henv_ != 0) {
-    SQLFreeHandle(SQL_HANDLE_ENV, load_handle<HENV>(henv_));
-    henv_ = 0;
+  env_.reset(); // after the DBC: the environment must outlive its connections
+}
+
+void Connection::drop_link_locked() noexcept {
+  // Cached statements belong to the old link: free them, then disconnect
+  // (errors ignored; a broken link is gone either way). Unpublish the running
+  // statement first so cancel() never reaches a freed handle.
+  {
+    std::scoped_lock lk(cancel_mtx_);
+    active_stmt_ = 0;
   }
+  clear_statement_cache_locked();
+  SQLDisconnect(load_handle<HDBC>(hdbc_));
+  ++conn_epoch_;
 }
 
 bool Connection::try_reconnect_locked() noexcept {
   // Assumes mtx_ is held
-  if (hdbc_ == 0 || henv_ == 0) return false;
-  auto hdbc = load_handle<HDBC>(hdbc_);
-  // Attempt to disconnect first, ignore errors
-  SQLDisconnect(hdbc);
-  connected_ = false;
+  if (hdbc_ == 0 || !env_) return false;
+  // Work done so far in an explicit transaction died with the connection;
+  // retrying the statement on a new one would commit only part of it
+  if (in_txn_) return false;
+  if (link_ == LinkState::Connected) drop_link_locked();
+  link_ = LinkState::Broken;
+  return reconnect_locked();
+}
 
-  SQLRETURN rc = SQL_ERROR;
+bool Connection::reconnect_locked() noexcept {
+  // Assumes mtx_ is held and link_ is Broken. A single attempt per call, so
+  // a caller never waits longer than one connect (plus Options::probe_wait);
+  // the breaker spaces out attempts across all connections to the target.
+  if (mode_ == ConnMode::None || !breaker_) return false;
+  try {
+    if (!breaker_->enter(true)) return false;
+  } catch (...) {
+    return false;
+  }
+  SQLRETURN rc = connect_stored_locked();
+  const bool ok = rc == SQL_SUCCESS || rc == SQL_SUCCESS_WITH_INFO;
+  breaker_->leave(ok || !is_connection_broken_sqlstate(first_sql_state(SQL_HANDLE_DBC, load_handle<HDBC>(hdbc_))));
+  if (ok) link_ = LinkState::Connected;
+  if (instr_) instr_->on_reconnect(ok);
+  return ok;
+}
+
+int Connection::connect_stored_locked() noexcept {
+  auto hdbc = load_handle<HDBC>(hdbc_);
   switch (mode_) {
-    case ConnMode::Dsn: {
-      if (dsn_.empty()) return false;
-      rc = SQLConnect(
+    case ConnMode::Dsn:
+      if (dsn_.empty()) return SQL_ERROR;
+      return SQLConnect(
           hdbc,
           to_sqlchar(dsn_.c_str()), SQL_NTS,
           to_sqlchar(uid_.c_str()), SQL_NTS,
           to_sqlchar(pwd_.c_str()), SQL_NTS);
-      break;
-    }
     case ConnMode::ConnStr: {
-      if (conn_str_.empty()) return false;
+      if (conn_str_.empty()) return SQL_ERROR;
       SQLCHAR outConn[1024];
       SQLSMALLINT outLen = 0;
-      rc = SQLDriverConnect(
+      return SQLDriverConnect(
           hdbc, nullptr,
           to_sqlchar(conn_str_.c_str()), SQL_NTS,
-          outConn, safe_smallint(sizeof(outConn), "SQLDriverConnect out buffer"), &outLen,
+          outConn, static_cast<SQLSMALLINT>(sizeof(outConn)), &outLen,
           SQL_DRIVER_NOPROMPT);
-      break;
     }
     case ConnMode::None:
     default:
-      return false;
+      return SQL_ERROR;
   }
-
-  if (rc == SQL_SUCCESS || rc == SQL_SUCCESS_WITH_INFO) {
-    connected_ = true;
-    return true;
-  }
-  return false;
 }
 
 void Connection::execute(std::string_view sql) {
-  std::scoped_lock lk(mtx_);
-  ensure_connected_locked();
+  execute(sql, {}, QueryOptions{});
+}
+
+void Connection::execute_direct_locked(std::string_view sql, std::chrono::milliseconds timeout) {
   auto hdbc = load_handle<HDBC>(hdbc_);
   int attempts = 0;
   for (;;) {
-    // RAII guard for statement handle
-    struct StmtGuard {
-      HSTMT h{};
-      explicit StmtGuard(HDBC dbc) {
-        SQLRETURN rc = SQLAllocHandle(SQL_HANDLE_STMT, dbc, &h);
-        if (!(rc == SQL_SUCCESS || rc == SQL_SUCCESS_WITH_INFO)) {
-          h = 0;
-        }
-      }
-      ~StmtGuard() {
-        if (h) { SQLCloseCursor(h); SQLFreeHandle(SQL_HANDLE_STMT, h); }
-      }
-    } stmt(hdbc);
-
-    SQLRETURN rc = (stmt.h ? SQL_SUCCESS : SQL_ERROR);
+    StatementLease stmt(*this);
+    SQLRETURN rc = stmt.allocate();
     if (!(rc == SQL_SUCCESS || rc == SQL_SUCCESS_WITH_INFO)) {
-      std::string st = first_sql_state(SQL_HANDLE_DBC, hdbc);
-      if (attempts == 0 && is_connection_broken_sqlstate(st) && try_reconnect_locked()) {
+      auto err = diag_error("SQLAllocHandle(SQL_HANDLE_STMT)", SQL_HANDLE_DBC, hdbc);
+      note_error_locked(sql, err);
+      stmt.release(); // release the statement before reconnecting
+      if (attempts == 0 && is_connection_broken_sqlstate(err.sqlstate()) && try_reconnect_locked()) {
         ++attempts; hdbc = load_handle<HDBC>(hdbc_); continue; // retry
       }
-      throw_diag(SQL_HANDLE_DBC, hdbc, "SQLAllocHandle(SQL_HANDLE_STMT)");
+      throw err;
     }
 
-    std::string sql_s(sql);
-    rc = SQLExecDirect(stmt.h, to_sqlchar(sql_s.c_str()), SQL_NTS);
+    rc = stmt.set_timeout(timeout);
     if (rc == SQL_SUCCESS || rc == SQL_SUCCESS_WITH_INFO) {
-      return;
+      rc = stmt.execute_direct(sql);
+      if (rc == SQL_SUCCESS || rc == SQL_SUCCESS_WITH_INFO) {
+        return;
+      }
     }
 
-    std::string st = first_sql_state(SQL_HANDLE_STMT, stmt.h);
-    std::string msg = diag_message(SQL_HANDLE_STMT, stmt.h);
-    if (attempts == 0 && is_connection_broken_sqlstate(st) && try_reconnect_locked()) {
+    auto err = diag_error("SQLExecDirect failed", SQL_HANDLE_STMT, stmt.get());
+    note_error_locked(sql, err);
+    stmt.release(); // release the statement before reconnecting
+    if (attempts == 0 && is_connection_broken_sqlstate(err.sqlstate()) && try_reconnect_locked()) {
       ++attempts; hdbc = load_handle<HDBC>(hdbc_); continue; // retry once
     }
-    throw std::runtime_error("SQLExecDirect failed: " + msg);
+    throw err;
   }
 }
 
 void Connection::execute(std::string_view sql, const std::vector<Param>& params) {
+  execute(sql, params, QueryOptions{});
+}
+
+void Connection::execute(std::string_view sql, const std::vector<Param>& params, const QueryOptions& options) {
   std::scoped_lock lk(mtx_);
   ensure_connected_locked();
+  if (params.empty()) {
+    execute_direct_locked(sql, options.timeout);
+    return;
+  }
   int attempts = 0;
   for (;;) {
     try {
-      execute_prepared_locked(sql, params.data(), static_cast<int>(params.size()));
+      execute_prepared_locked(sql, params.data(), static_cast<int>(params.size()), options.timeout);
       return;
-    } catch (const std::runtime_error& ex) {
-      // Heuristically decide if we should reconnect based on last diagnostics on DBC
-      auto hdbc = load_handle<HDBC>(hdbc_);
-      std::string st = first_sql_state(SQL_HANDLE_DBC, hdbc);
-      if (attempts == 0 && is_connection_broken_sqlstate(st) && try_reconnect_locked()) {
+    } catch (const Error& ex) {
+      // Decide on the diagnostics the failure already carries
+      if (attempts == 0 && is_connection_broken_sqlstate(ex.sqlstate()) && try_reconnect_locked()) {
         ++attempts; continue; // retry once
       }
       throw; // propagate original
@@ -360,231 +1438,494 @@ void Connection::execute(std::string_view sql, const std::vector<Param>& params)
   }
 }
 
-void Connection::execute_prepared_locked(std::string_view sql, const Param* params, int param_count) {
+void Connection::execute_prepared_locked(std::string_view sql, const Param* params, int param_count,
+                                         std::chrono::milliseconds timeout) {
   auto hdbc = load_handle<HDBC>(hdbc_);
   int attempts = 0;
   for (;;) {
-    struct StmtGuard {
-      HSTMT h{};
-      explicit StmtGuard(HDBC dbc) {
-        SQLRETURN rc = SQLAllocHandle(SQL_HANDLE_STMT, dbc, &h);
-        if (!(rc == SQL_SUCCESS || rc == SQL_SUCCESS_WITH_INFO)) { h = 0; }
-      }
-      ~StmtGuard() { if (h) { SQLCloseCursor(h); SQLFreeHandle(SQL_HANDLE_STMT, h);} }
-    } stmt(hdbc);
-    SQLRETURN rc = (stmt.h ? SQL_SUCCESS : SQL_ERROR);
+    StatementLease stmt(*this);
+    SQLRETURN rc = stmt.prepare(sql);
     if (!(rc == SQL_SUCCESS || rc == SQL_SUCCESS_WITH_INFO)) {
-      std::string st = first_sql_state(SQL_HANDLE_DBC, hdbc);
-      if (attempts == 0 && is_connection_broken_sqlstate(st) && try_reconnect_locked()) {
+      auto err = stmt.get() ? diag_error("SQLPrepare failed", SQL_HANDLE_STMT, stmt.get())
+                            : diag_error("SQLAllocHandle(SQL_HANDLE_STMT)", SQL_HANDLE_DBC, hdbc);
+      note_error_locked(sql, err);
+      stmt.release(); // release the statement before reconnecting
+      if (attempts == 0 && is_connection_broken_sqlstate(err.sqlstate()) && try_reconnect_locked()) {
         ++attempts; hdbc = load_handle<HDBC>(hdbc_); continue;
       }
-      throw_diag(SQL_HANDLE_DBC, hdbc, "SQLAllocHandle(SQL_HANDLE_STMT)");
+      throw err;
     }
 
-    std::string sql_s(sql);
-    rc = SQLPrepare(stmt.h, to_sqlchar(sql_s.c_str()), SQL_NTS);
+    BoundParams bound;
+    rc = stmt.set_timeout(timeout);
+    if (rc == SQL_SUCCESS || rc == SQL_SUCCESS_WITH_INFO) {
+      rc = bind_params(stmt.get(), params, param_count, bound);
+    }
     if (!(rc == SQL_SUCCESS || rc == SQL_SUCCESS_WITH_INFO)) {
-      std::string st = first_sql_state(SQL_HANDLE_STMT, stmt.h);
-      std::string msg = diag_message(SQL_HANDLE_STMT, stmt.h);
-      if (attempts == 0 && is_connection_broken_sqlstate(st) && try_reconnect_locked()) {
-        ++attempts; hdbc = load_handle<HDBC>(hdbc_); continue;
-      }
-      throw std::runtime_error("SQLPrepare failed: " + msg);
-    }
-
-    // Storage for bound values and indicators to keep memory alive
-    std::vector<int32_t> i32_vals; i32_vals.reserve(param_count);
-    std::vector<int64_t> i64_vals; i64_vals.reserve(param_count);
-    std::vector<double>  dbl_vals; dbl_vals.reserve(param_count);
-    std::vector<std::string> str_vals; str_vals.reserve(param_count);
-    std::vector<SQLLEN> ind_vals(param_count, 0);
-
-    bool bind_ok = true;
-    for (int i = 0; i < param_count; ++i) {
-      SQLUSMALLINT paramNum = static_cast<SQLUSMALLINT>(i + 1);
-      SQLSMALLINT cType = 0;
-      SQLSMALLINT sqlType = 0;
-      SQLULEN colDef = 0;
-      SQLSMALLINT scale = 0;
-      SQLPOINTER valPtr = nullptr;
-      SQLLEN* indPtr = &ind_vals[i];
-
-      const auto& v = params[i].value;
-      SQLLEN buffer_len = 0;
-      if (std::holds_alternative<std::nullptr_t>(v)) {
-        // Use non-null dummy pointer and mark indicator as NULL
-        cType = SQL_C_CHAR; sqlType = SQL_VARCHAR; colDef = 1; scale = 0; valPtr = &g_null_param_dummy; *indPtr = SQL_NULL_DATA; buffer_len = 1;
-      } else if (auto pv = std::get_if<int32_t>(&v)) {
-        cType = SQL_C_SLONG; sqlType = SQL_INTEGER; i32_vals.push_back(*pv); valPtr = &i32_vals.back(); *indPtr = sizeof(int32_t); buffer_len = sizeof(int32_t);
-      } else if (auto pv = std::get_if<int64_t>(&v)) {
-        cType = SQL_C_SBIGINT; sqlType = SQL_BIGINT; i64_vals.push_back(*pv); valPtr = &i64_vals.back(); *indPtr = sizeof(int64_t); buffer_len = sizeof(int64_t);
-      } else if (auto pv = std::get_if<double>(&v)) {
-        cType = SQL_C_DOUBLE; sqlType = SQL_DOUBLE; dbl_vals.push_back(*pv); valPtr = &dbl_vals.back(); *indPtr = sizeof(double); buffer_len = sizeof(double);
-      } else if (auto pv = std::get_if<std::string>(&v)) {
-        cType = SQL_C_CHAR; sqlType = SQL_VARCHAR;
-        // Use a safe column definition to avoid truncation metadata issues
-        const SQLULEN actual = static_cast<SQLULEN>(pv->size());
-        const SQLULEN safe_def = std::max<SQLULEN>(actual, 4096);
-        colDef = std::max<SQLULEN>(safe_def, 1);
-        scale = 0;
-        str_vals.push_back(*pv);
-        valPtr = reinterpret_cast<SQLPOINTER>(str_vals.back().data());
-        *indPtr = SQL_NTS; // null-terminated
-        buffer_len = static_cast<SQLLEN>(str_vals.back().size() + 1);
-      }
-
-      rc = SQLBindParameter(stmt.h, paramNum, SQL_PARAM_INPUT,
-                            cType, sqlType, colDef, scale,
-                            valPtr, buffer_len, indPtr);
-      if (!(rc == SQL_SUCCESS || rc == SQL_SUCCESS_WITH_INFO)) {
-        std::string st = first_sql_state(SQL_HANDLE_STMT, stmt.h);
-        std::string msg = diag_message(SQL_HANDLE_STMT, stmt.h);
-        if (attempts == 0 && is_connection_broken_sqlstate(st) && try_reconnect_locked()) {
-          ++attempts; hdbc = load_handle<HDBC>(hdbc_); bind_ok = false; break; // retry
-        }
-        throw std::runtime_error("SQLBindParameter failed: " + msg);
+      auto err = diag_error("SQLBindParameter failed", SQL_HANDLE_STMT, stmt.get());
+      note_error_locked(sql, err);
+      stmt.release(); // release the statement before reconnecting
+      if (attempts == 0 && is_connection_broken_sqlstate(err.sqlstate()) && try_reconnect_locked()) {
+        ++attempts; hdbc = load_handle<HDBC>(hdbc_); continue; // retry
       }
+      throw err;
     }
-    if (!bind_ok) continue; // go retry
 
-    rc = SQLExecute(stmt.h);
+    rc = stmt.execute_prepared(sql);
     if (rc == SQL_SUCCESS || rc == SQL_SUCCESS_WITH_INFO) {
       return;
     }
 
-    std::string st = first_sql_state(SQL_HANDLE_STMT, stmt.h);
-    std::string msg = diag_message(SQL_HANDLE_STMT, stmt.h);
-    if (attempts == 0 && is_connection_broken_sqlstate(st) && try_reconnect_locked()) {
+    auto err = diag_error("SQLExecute failed", SQL_HANDLE_STMT, stmt.get());
+    note_error_locked(sql, err);
+    stmt.release(); // release the statement before reconnecting
+    if (attempts == 0 && is_connection_broken_sqlstate(err.sqlstate()) && try_reconnect_locked()) {
       ++attempts; hdbc = load_handle<HDBC>(hdbc_); continue; // retry once
     }
-    throw std::runtime_error("SQLExecute failed: " + msg);
+    throw err;
   }
 }
 
-void Connection::query_to_callback(std::string_view sql, const Param* params, int param_count,
-                                   const std::function<void(const Row&)>& on_row) {
+BatchResult Connection::execute_batch(std::string_view sql, std::span<const std::vector<Param>> rows,
+                                      const BatchOptions& options) {
+  BatchResult result;
+  result.row_status.assign(rows.size(), ParamStatus::Unused);
+  if (rows.empty()) return result;
+  const std::size_t width = rows.front().size();
+  if (width == 0) {
+    throw std::invalid_argument("execute_batch: rows must have at least one parameter");
+  }
+  for (const auto& row : rows) {
+    if (row.size() != width) {
+      throw std::invalid_argument("execute_batch: all rows must have the same number of parameters");
+    }
+  }
+  const std::size_t chunk = options.chunk_size ? options.chunk_size : rows.size();
+
   std::scoped_lock lk(mtx_);
   ensure_connected_locked();
+  for (std::size_t first = 0; first < rows.size(); first += chunk) {
+    execute_batch_chunk_locked(sql, rows.subspan(first, std::min(chunk, rows.size() - first)), first,
+                               options.timeout, result);
+  }
+  return result;
+}
 
-  auto hdbc = load_handle<HDBC>(hdbc_);
+void Connection::execute_batch_chunk_locked(std::string_view sql, std::span<const std::vector<Param>> rows,
+                                            std::size_t first_row, std::chrono::milliseconds timeout,
+                                            BatchResult& result) {
   int attempts = 0;
-  bool prepared = (params != nullptr && param_count > 0);
-  bool delivered_any = false;
 
-  auto run_once = [&](HDBC use_hdbc, int& out_rows) -> std::pair<bool, std::string> {
-    out_rows = 0;
-    struct StmtGuard { HSTMT h{}; explicit StmtGuard(HDBC dbc){ SQLRETURN r=SQLAllocHandle(SQL_HANDLE_STMT, dbc, &h); if(!(r==SQL_SUCCESS||r==SQL_SUCCESS_WITH_INFO)) h=0;} ~StmtGuard(){ if(h){ SQLCloseCursor(h); SQLFreeHandle(SQL_HANDLE_STMT, h);} } } stmt(use_hdbc);
-    SQLRETURN rc = (stmt.h ? SQL_SUCCESS : SQL_ERROR);
+  // Runs the chunk once. Returns a broken-link failure worth one retry, by
+  // which time the parameter arrays and the statement have been released
+  // (a reconnect frees the cached handle); other failures are thrown.
+  auto run_once = [&]() -> std::optional<Error> {
+    const auto retryable = [&](const Error& err) {
+      return attempts == 0 && is_connection_broken_sqlstate(err.sqlstate());
+    };
+    StatementLease stmt(*this);
+    SQLRETURN rc = stmt.prepare(sql);
     if (!(rc == SQL_SUCCESS || rc == SQL_SUCCESS_WITH_INFO)) {
-      std::string st = first_sql_state(SQL_HANDLE_DBC, use_hdbc);
-      if (st.empty()) st = "HY000";
-      return {false, st};
+      auto err = stmt.get() ? diag_error("SQLPrepare failed", SQL_HANDLE_STMT, stmt.get())
+                            : diag_error("SQLAllocHandle(SQL_HANDLE_STMT)", SQL_HANDLE_DBC, load_handle<HDBC>(hdbc_));
+      note_error_locked(sql, err);
+      if (retryable(err)) return err;
+      throw err;
     }
 
-    if (prepared) {
-      std::string sql_s(sql);
-      rc = SQLPrepare(stmt.h, to_sqlchar(sql_s.c_str()), SQL_NTS);
-      if (!(rc == SQL_SUCCESS || rc == SQL_SUCCESS_WITH_INFO)) {
-        std::string st = first_sql_state(SQL_HANDLE_STMT, stmt.h);
-        if (st.empty()) st = first_sql_state(SQL_HANDLE_DBC, use_hdbc);
-        if (st.empty()) st = "HY000";
-        return {false, st};
-      }
+    ParamArrays arrays(stmt.get(), rows.size());
+    rc = stmt.set_timeout(timeout);
+    if (rc == SQL_SUCCESS || rc == SQL_SUCCESS_WITH_INFO) rc = arrays.bind(rows);
+    if (!(rc == SQL_SUCCESS || rc == SQL_SUCCESS_WITH_INFO)) {
+      auto err = diag_error("SQLBindParameter (batch) failed", SQL_HANDLE_STMT, stmt.get());
+      note_error_locked(sql, err);
+      if (retryable(err)) return err;
+      throw err;
+    }
+
+    rc = stmt.execute_prepared(sql);
+    // SQL_NO_DATA: searched UPDATE/DELETE matched no rows, which is not an error
+    const bool exec_ok = (rc == SQL_SUCCESS || rc == SQL_SUCCESS_WITH_INFO || rc == SQL_NO_DATA);
+    std::optional<Error> err;
+    bool row_errors = false;
+    if (!exec_ok) {
+      err = diag_error("SQLExecute (batch) failed", SQL_HANDLE_STMT, stmt.get());
+      note_error_locked(sql, *err);
+      if (retryable(*err)) return err; // retry this chunk once
+      for (auto s : arrays.status()) row_errors = row_errors || (s == SQL_PARAM_ERROR);
+      if (!row_errors) throw *err;
+    }
 
-      std::vector<int32_t> i32_vals; i32_vals.reserve(param_count);
-      std::vector<int64_t> i64_vals; i64_vals.reserve(param_count);
-      std::vector<double>  dbl_vals; dbl_vals.reserve(param_count);
-      std::vector<std::string> str_vals; str_vals.reserve(param_count);
-      std::vector<SQLLEN> ind_vals(param_count, 0);
-
-      for (int i = 0; i < param_count; ++i) {
-        SQLUSMALLINT paramNum = static_cast<SQLUSMALLINT>(i + 1);
-        SQLSMALLINT cType = 0; SQLSMALLINT sqlType = 0; SQLULEN colDef = 0; SQLSMALLINT scale = 0; SQLPOINTER valPtr = nullptr; SQLLEN* indPtr = &ind_vals[i];
-        const auto& v = params[i].value;
-        SQLLEN buffer_len = 0;
-        if (std::holds_alternative<std::nullptr_t>(v)) { cType = SQL_C_CHAR; sqlType = SQL_VARCHAR; colDef = 1; scale = 0; valPtr = &g_null_param_dummy; *indPtr = SQL_NULL_DATA; buffer_len = 1; }
-        else if (auto pv = std::get_if<int32_t>(&v)) { cType = SQL_C_SLONG; sqlType = SQL_INTEGER; i32_vals.push_back(*pv); valPtr = &i32_vals.back(); *indPtr = sizeof(int32_t); buffer_len = sizeof(int32_t); }
-        else if (auto pv = std::get_if<int64_t>(&v)) { cType = SQL_C_SBIGINT; sqlType = SQL_BIGINT; i64_vals.push_back(*pv); valPtr = &i64_vals.back(); *indPtr = sizeof(int64_t); buffer_len = sizeof(int64_t); }
-        else if (auto pv = std::get_if<double>(&v)) { cType = SQL_C_DOUBLE; sqlType = SQL_DOUBLE; dbl_vals.push_back(*pv); valPtr = &dbl_vals.back(); *indPtr = sizeof(double); buffer_len = sizeof(double); }
-        else if (auto pv = std::get_if<std::string>(&v)) { cType = SQL_C_CHAR; sqlType = SQL_VARCHAR; const SQLULEN actual = static_cast<SQLULEN>(pv->size()); const SQLULEN safe_def = std::max<SQLULEN>(actual, 4096); colDef = std::max<SQLULEN>(safe_def, 1); scale = 0; str_vals.push_back(*pv); valPtr = reinterpret_cast<SQLPOINTER>(str_vals.back().data()); *indPtr = SQL_NTS; buffer_len = static_cast<SQLLEN>(str_vals.back().size() + 1); }
-        rc = SQLBindParameter(stmt.h, paramNum, SQL_PARAM_INPUT, cType, sqlType, colDef, scale, valPtr, buffer_len, indPtr);
-        if (!(rc == SQL_SUCCESS || rc == SQL_SUCCESS_WITH_INFO)) { std::string st = first_sql_state(SQL_HANDLE_STMT, stmt.h); if (st.empty()) st = first_sql_state(SQL_HANDLE_DBC, use_hdbc); if (st.empty()) st = "HY000"; return {false, st}; }
+    for (std::size_t i = 0; i < rows.size(); ++i) {
+      ParamStatus out = ParamStatus::Unused;
+      switch (arrays.status()[i]) {
+        case SQL_PARAM_SUCCESS:           out = ParamStatus::Success; break;
+        case SQL_PARAM_SUCCESS_WITH_INFO: out = ParamStatus::SuccessWithInfo; break;
+        case SQL_PARAM_ERROR:             out = ParamStatus::Error; break;
+        case SQL_PARAM_DIAG_UNAVAILABLE:  out = exec_ok ? ParamStatus::Success : ParamStatus::Error; break;
+        default:                          out = ParamStatus::Unused; break;
       }
+      result.row_status[first_row + i] = out;
+    }
+    result.rows_processed += arrays.processed();
+    SQLLEN affected = 0;
+    rc = SQLRowCount(stmt.get(), &affected);
+    if ((rc == SQL_SUCCESS || rc == SQL_SUCCESS_WITH_INFO) && affected > 0) {
+      result.rows_affected += affected;
+    }
+    if (row_errors && result.error_message.empty()) result.error_message = err->what();
+    return std::nullopt;
+  };
 
-      rc = SQLExecute(stmt.h);
-      if (!(rc == SQL_SUCCESS || rc == SQL_SUCCESS_WITH_INFO)) { std::string st = first_sql_state(SQL_HANDLE_STMT, stmt.h); if (st.empty()) st = first_sql_state(SQL_HANDLE_DBC, use_hdbc); if (st.empty()) st = "HY000"; return {false, st}; }
-    } else {
-      std::string sql_s(sql);
-      rc = SQLExecDirect(stmt.h, to_sqlchar(sql_s.c_str()), SQL_NTS);
-      if (!(rc == SQL_SUCCESS || rc == SQL_SUCCESS_WITH_INFO)) { std::string st = first_sql_state(SQL_HANDLE_STMT, stmt.h); if (st.empty()) st = first_sql_state(SQL_HANDLE_DBC, use_hdbc); if (st.empty()) st = "HY000"; return {false, st}; }
+  for (;;) {
+    auto err = run_once();
+    if (!err) return;
+    if (try_reconnect_locked()) {
+      ++attempts; continue; // retry this chunk once
     }
+    throw *err;
+  }
+}
+
+void Connection::query_to_callback(std::string_view sql, const Param* params, int param_count,
+                                   const QueryOptions& options, const std::function<void(const Row&)>& on_row) {
+  std::scoped_lock lk(mtx_);
+  ensure_connected_locked();
+
+  bool delivered_any = false;
+
+  // Returns the failure (diagnostics read once), or nothing on success
+  auto run_once = [&]() -> std::optional<Error> {
+    StatementLease stmt(*this);
+    BoundParams bound;
+    auto failed = [&](const char* where) -> std::optional<Error> {
+      if (stmt.get()) return diag_error(where, SQL_HANDLE_STMT, stmt.get());
+      return diag_error(where, SQL_HANDLE_DBC, load_handle<HDBC>(hdbc_));
+    };
+
+    SQLRETURN rc = stmt.execute(sql, params, param_count, bound, options.timeout);
+    if (!(rc == SQL_SUCCESS || rc == SQL_SUCCESS_WITH_INFO)) return failed("Query failed (prepare/execute)");
+
+    ResultSet rs(stmt.get(), cached_descriptor_locked(sql));
+    rs.instrument(instr_, sql);
+    rc = rs.open(options.rowset_size);
+    if (!(rc == SQL_SUCCESS || rc == SQL_SUCCESS_WITH_INFO)) return failed("Query failed (bind)");
 
     while (true) {
-      rc = SQLFetch(stmt.h);
+      rc = rs.fetch();
       if (rc == SQL_NO_DATA) break;
-      if (!(rc == SQL_SUCCESS || rc == SQL_SUCCESS_WITH_INFO)) {
-        std::string st = first_sql_state(SQL_HANDLE_STMT, stmt.h);
-        if (st.empty()) st = first_sql_state(SQL_HANDLE_DBC, use_hdbc);
-        if (st.empty()) st = "HY000"; // generic error state, never empty
-        return {false, st};
+      if (!(rc == SQL_SUCCESS || rc == SQL_SUCCESS_WITH_INFO)) return failed("Query failed (fetch)");
+      for (std::size_t i = 0; i < rs.rows(); ++i) {
+        Row row{&rs, i};
+        on_row(row);
+        delivered_any = true;
       }
-      Row row{store_handle(stmt.h)};
-      on_row(row);
-      ++out_rows;
-      delivered_any = true;
     }
-    return {true, std::string{}};
+    return std::nullopt;
   };
 
-  for (;;) {
-    int out_rows = 0;
-    auto [ok, state] = run_once(hdbc, out_rows);
-    if (ok) return;
-    if (attempts == 0 && is_connection_broken_sqlstate(state) && try_reconnect_locked()) {
-      ++attempts; hdbc = load_handle<HDBC>(hdbc_); continue; // retry once from scratch
-    }
-    // If not retried, throw diagnostics from DBC or state we have
-    if (prepared) {
-      throw std::runtime_error("Query failed (prepare/execute/fetch) and reconnect did not resolve the issue.");
+  for (int attempts = 0;; ++attempts) {
+    auto err = run_once();
+    if (!err) return;
+    note_error_locked(sql, *err);
+    // Retry once from scratch, unless rows already reached the callback
+    if (attempts == 0 && !delivered_any && is_connection_broken_sqlstate(err->sqlstate()) && try_reconnect_locked()) {
+      continue;
+    }
+    throw *err;
+  }
+}
+
+// ---------------- Cursor ----------------
+
+// Members are destroyed in reverse order: fetch state, then the statement,
+// and the connection's mutex is unlocked last.
+struct Connection::Cursor::State {
+  std::unique_lock<std::mutex> lock;
+  StatementLease stmt;
+  BoundParams bound;
+  std::optional<ResultSet> rs;
+  std::unique_ptr<Row> row;   // view handed out by next(), re-pointed per row
+  bool positioned{false};     // row refers to a fetched rowset
+
+  explicit State(Connection& conn) : stmt(conn) {}
+};
+
+Connection::Cursor::Cursor() noexcept = default;
+Connection::Cursor::~Cursor() = default;
+Connection::Cursor::Cursor(Cursor&&) noexcept = default;
+Connection::Cursor& Connection::Cursor::operator=(Cursor&&) noexcept = default;
+Connection::Cursor::Cursor(std::unique_ptr<State> state) noexcept : state_(std::move(state)) {}
+
+void Connection::Cursor::close() noexcept { state_.reset(); }
+
+const Connection::Row* Connection::Cursor::next() {
+  if (!state_) return nullptr;
+  auto& rs = *state_->rs;
+  Row& row = *state_->row;
+  if (state_->positioned && row.index_ + 1 < rs.rows()) {
+    ++row.index_; // next row of the current rowset
+    return &row;
+  }
+  SQLRETURN rc = rs.fetch();
+  if (rc == SQL_NO_DATA) {
+    close();
+    return nullptr;
+  }
+  if (!(rc == SQL_SUCCESS || rc == SQL_SUCCESS_WITH_INFO)) {
+    auto err = diag_error("SQLFetch failed", SQL_HANDLE_STMT, rs.hstmt());
+    rs.note_error(err);
+    close();
+    throw err;
+  }
+  state_->positioned = true;
+  row.index_ = 0;
+  return &row;
+}
+
+Connection::Cursor Connection::open_cursor(std::string_view sql, const std::vector<Param>& params,
+                                           const QueryOptions& options) {
+  return open_cursor_impl(sql, params.data(), static_cast<int>(params.size()), options, {});
+}
+
+Connection::Cursor Connection::open_cursor_impl(std::string_view sql, const Param* params, int param_count,
+                                                const QueryOptions& options, std::span<const ColumnType> column_types) {
+  std::unique_lock lk(mtx_);
+  ensure_connected_locked();
+
+  for (int attempts = 0;; ++attempts) {
+    auto state = std::make_unique<Cursor::State>(*this);
+    SQLRETURN rc = state->stmt.execute(sql, params, param_count, state->bound, options.timeout);
+    if (rc == SQL_SUCCESS || rc == SQL_SUCCESS_WITH_INFO) {
+      auto& rs = state->rs.emplace(state->stmt.get(), cached_descriptor_locked(sql));
+      rs.instrument(instr_, sql);
+      rc = rs.open(options.rowset_size, column_types);
+    }
+    if (rc == SQL_SUCCESS || rc == SQL_SUCCESS_WITH_INFO) {
+      state->row.reset(new Row(&*state->rs, 0));
+      state->lock = std::move(lk);
+      return Cursor(std::move(state));
+    }
+
+    auto err = state->stmt.get() != HSTMT{}
+                   ? diag_error("open_cursor failed", SQL_HANDLE_STMT, state->stmt.get())
+                   : diag_error("open_cursor failed", SQL_HANDLE_DBC, load_handle<HDBC>(hdbc_));
+    note_error_locked(sql, err);
+    state.reset(); // release the statement before reconnecting
+    if (attempts == 0 && is_connection_broken_sqlstate(err.sqlstate()) && try_reconnect_locked()) continue;
+    throw err;
+  }
+}
+
+// ---------------- Columnar results ----------------
+
+namespace {
+
+// Storage a columnar result uses for a column: that of its block fetch binding
+ColumnType columnar_type(SQLSMALLINT c_type) noexcept {
+  switch (c_type) {
+    case SQL_C_SBIGINT: return ColumnType::Integer;
+    case SQL_C_DOUBLE:  return ColumnType::Real;
+    default:            return ColumnType::Text;
+  }
+}
+
+void mark_null(ColumnarResult::Column& c, std::size_t row) {
+  c.nulls[row / 64] |= std::uint64_t{1} << (row % 64);
+}
+
+// Append `n` fixed-width elements of a bound column (int64 or double)
+template <class T>
+void append_bound_numbers(ColumnarResult::Column& c, std::vector<T>& values, const BoundColumn& bc,
+                          std::size_t first_row, std::size_t n) {
+  const std::size_t base = values.size();
+  values.resize(base + n);
+  std::memcpy(values.data() + base, bc.data.data(), n * sizeof(T)); // bound by column: already contiguous
+  for (std::size_t i = 0; i < n; ++i) {
+    if (bc.ind[i] == SQL_NULL_DATA) {
+      values[base + i] = T{};
+      mark_null(c, first_row + i);
+    }
+  }
+}
+
+} // namespace
+
+ColumnarResult Connection::query_columnar(std::string_view sql, const std::vector<Param>& params,
+                                          const QueryOptions& options, std::span<const ColumnType> types) {
+  QueryOptions block_options = options;
+  if (block_options.rowset_size <= 1) block_options.rowset_size = kColumnarRowsetSize;
+  Cursor cursor = open_cursor_impl(sql, params.data(), static_cast<int>(params.size()), block_options, types);
+  auto& rs = *cursor.state_->rs;
+
+  ColumnarResult out;
+  out.descriptor = rs.shared_descriptor();
+  const auto& infos = out.descriptor->columns();
+  out.columns.resize(infos.size());
+  std::vector<SQLSMALLINT> c_types(infos.size());
+  for (std::size_t i = 0; i < infos.size(); ++i) {
+    if (rs.block()) {
+      c_types[i] = rs.column(static_cast<int>(i + 1)).c_type;
     } else {
-      throw std::runtime_error("Query failed (exec/fetch) and reconnect did not resolve the issue.");
+      // Same representation the binding would have chosen; unbindable => text
+      BoundColumn layout;
+      const auto hint = i < types.size() ? types[i] : ColumnType::Any;
+      c_types[i] = block_layout(infos[i].sql_type, static_cast<SQLULEN>(infos[i].size), infos[i].decimal_digits,
+                                hint, layout) ? layout.c_type : SQL_C_CHAR;
+    }
+    out.columns[i].type = columnar_type(c_types[i]);
+    if (out.columns[i].type == ColumnType::Text) out.columns[i].offsets.push_back(0);
+  }
+
+  Row& row = *cursor.state_->row;
+  for (;;) {
+    SQLRETURN rc = rs.fetch();
+    if (rc == SQL_NO_DATA) break;
+    if (!(rc == SQL_SUCCESS || rc == SQL_SUCCESS_WITH_INFO)) {
+      auto err = diag_error("SQLFetch failed", SQL_HANDLE_STMT, rs.hstmt());
+      rs.note_error(err);
+      throw err;
+    }
+    const std::size_t first = out.rows;
+    const std::size_t n = rs.rows();
+    out.rows += n;
+    for (std::size_t i = 0; i < out.columns.size(); ++i) {
+      auto& c = out.columns[i];
+      const int col = static_cast<int>(i + 1);
+      c.nulls.resize((out.rows + 63) / 64, 0);
+      if (rs.block()) {
+        const auto& bc = rs.column(col);
+        switch (c.type) {
+          case ColumnType::Integer: append_bound_numbers(c, c.ints, bc, first, n); break;
+          case ColumnType::Real:    append_bound_numbers(c, c.reals, bc, first, n); break;
+          default:
+            for (std::size_t r = 0; r < n; ++r) {
+              if (bc.ind[r] == SQL_NULL_DATA) {
+                mark_null(c, first + r);
+              } else {
+                const auto v = bound_text(bc, r, col);
+                c.chars.insert(c.chars.end(), v.begin(), v.end());
+              }
+              c.offsets.push_back(c.chars.size());
+            }
+        }
+        continue;
+      }
+      // Row-at-a-time fallback: one row per fetch, read through the getters
+      row.index_ = 0;
+      switch (c.type) {
+        case ColumnType::Integer: {
+          auto v = row.getInt64(col);
+          if (!v) mark_null(c, first);
+          c.ints.push_back(v.value_or(0));
+          break;
+        }
+        case ColumnType::Real: {
+          auto v = row.getDouble(col);
+          if (!v) mark_null(c, first);
+          c.reals.push_back(v.value_or(0.0));
+          break;
+        }
+        default: {
+          auto v = c_types[i] == SQL_C_BINARY ? row.getBytes(col) : row.getStringView(col);
+          if (v) {
+            c.chars.insert(c.chars.end(), v->begin(), v->end());
+          } else {
+            mark_null(c, first);
+          }
+          c.offsets.push_back(c.chars.size());
+        }
+      }
     }
   }
+  return out;
+}
+
+// ---------------- Result metadata ----------------
+
+ResultDescriptor::ResultDescriptor(std::vector<ColumnInfo> columns) : columns_(std::move(columns)) {
+  index_.reserve(columns_.size());
+  for (std::size_t i = 0; i < columns_.size(); ++i) {
+    index_.emplace(columns_[i].name, static_cast<int>(i + 1)); // keeps the first of repeated names
+  }
+}
+
+const ColumnInfo& ResultDescriptor::column(int col) const {
+  if (col < 1 || static_cast<std::size_t>(col) > columns_.size()) {
+    throw std::out_of_range("Column index out of range: " + std::to_string(col));
+  }
+  return columns_[static_cast<std::size_t>(col - 1)];
 }
 
+std::optional<int> ResultDescriptor::find(std::string_view name) const noexcept {
+  auto it = index_.find(name);
+  if (it == index_.end()) return std::nullopt;
+  return it->second;
+}
+
+int ResultDescriptor::index_of(std::string_view name) const {
+  auto it = index_.find(name);
+  if (it == index_.end()) throw std::out_of_range("No result column named " + std::string(name));
+  return it->second;
+}
+
+const ResultDescriptor& Connection::Row::descriptor() const { return rs_->descriptor(); }
+
 // ---------------- Row getters ----------------
 
 std::optional<int32_t> Connection::Row::getInt32(int col) const {
+  if (rs_->block()) {
+    const auto& c = rs_->column(col);
+    if (c.ind[index_] == SQL_NULL_DATA) return std::nullopt;
+    const int64_t v = bound_number<int64_t>(c, index_, col);
+    if (v < std::numeric_limits<int32_t>::min() || v > std::numeric_limits<int32_t>::max()) {
+      throw_block_error(col, "numeric value out of range");
+    }
+    return static_cast<int32_t>(v);
+  }
+  const HSTMT hstmt = rs_->hstmt();
   SQLLEN ind = 0;
   int32_t val = 0;
-  SQLRETURN rc = SQLGetData(load_handle<HSTMT>(hstmt_), static_cast<SQLUSMALLINT>(col), SQL_C_SLONG, &val, sizeof(val), &ind);
+  SQLRETURN rc = SQLGetData(hstmt, static_cast<SQLUSMALLINT>(col), SQL_C_SLONG, &val, sizeof(val), &ind);
   if (rc == SQL_NO_DATA) return std::nullopt;
   if (!(rc == SQL_SUCCESS || rc == SQL_SUCCESS_WITH_INFO)) {
-    throw_diag(SQL_HANDLE_STMT, load_handle<HSTMT>(hstmt_), "SQLGetData(int32)");
+    throw_diag(SQL_HANDLE_STMT, hstmt, "SQLGetData(int32)");
   }
   if (ind == SQL_NULL_DATA) return std::nullopt;
   return val;
 }
 
 std::optional<int64_t> Connection::Row::getInt64(int col) const {
+  if (rs_->block()) {
+    const auto& c = rs_->column(col);
+    if (c.ind[index_] == SQL_NULL_DATA) return std::nullopt;
+    return bound_number<int64_t>(c, index_, col);
+  }
+  const HSTMT hstmt = rs_->hstmt();
   SQLLEN ind = 0;
   int64_t val = 0;
-  SQLRETURN rc = SQLGetData(load_handle<HSTMT>(hstmt_), static_cast<SQLUSMALLINT>(col), SQL_C_SBIGINT, &val, sizeof(val), &ind);
+  SQLRETURN rc = SQLGetData(hstmt, static_cast<SQLUSMALLINT>(col), SQL_C_SBIGINT, &val, sizeof(val), &ind);
   if (rc == SQL_NO_DATA) return std::nullopt;
   if (!(rc == SQL_SUCCESS || rc == SQL_SUCCESS_WITH_INFO)) {
-    throw_diag(SQL_HANDLE_STMT, load_handle<HSTMT>(hstmt_), "SQLGetData(int64)");
+    throw_diag(SQL_HANDLE_STMT, hstmt, "SQLGetData(int64)");
   }
   if (ind == SQL_NULL_DATA) return std::nullopt;
   return val;
 }
 
 std::optional<double> Connection::Row::getDouble(int col) const {
+  if (rs_->block()) {
+    const auto& c = rs_->column(col);
+    if (c.ind[index_] == SQL_NULL_DATA) return std::nullopt;
+    return bound_number<double>(c, index_, col);
+  }
+  const HSTMT hstmt = rs_->hstmt();
   SQLLEN ind = 0;
   double val = 0.0;
-  SQLRETURN rc = SQLGetData(load_handle<HSTMT>(hstmt_), static_cast<SQLUSMALLINT>(col), SQL_C_DOUBLE, &val, sizeof(val), &ind);
+  SQLRETURN rc = SQLGetData(hstmt, static_cast<SQLUSMALLINT>(col), SQL_C_DOUBLE, &val, sizeof(val), &ind);
   if (rc == SQL_NO_DATA) return std::nullopt;
   if (!(rc == SQL_SUCCESS || rc == SQL_SUCCESS_WITH_INFO)) {
-    throw_diag(SQL_HANDLE_STMT, load_handle<HSTMT>(hstmt_), "SQLGetData(double)");
+    throw_diag(SQL_HANDLE_STMT, hstmt, "SQLGetData(double)");
   }
   if (ind == SQL_NULL_DATA) return std::nullopt;
   return val;
@@ -592,47 +1933,93 @@ std::optional<double> Connection::Row::getDouble(int col) const {
 
 std::optional<std::string> Connection::Row::getString(int col) const {
   std::string result;
-  SQLLEN ind = 0;
-  // First call with small buffer to get length
-  char buf[256];
-  SQLLEN got = 0;
-  SQLRETURN rc = SQLGetData(load_handle<HSTMT>(hstmt_), static_cast<SQLUSMALLINT>(col), SQL_C_CHAR,
-                            buf, sizeof(buf), &ind);
-  if (rc == SQL_NO_DATA) return std::nullopt;
-  if (!(rc == SQL_SUCCESS || rc == SQL_SUCCESS_WITH_INFO)) {
-    throw_diag(SQL_HANDLE_STMT, load_handle<HSTMT>(hstmt_), "SQLGetData(string)");
+  if (!getStringInto(col, result)) return std::nullopt;
+  return result;
+}
+
+bool Connection::Row::getStringInto(int col, std::string& out) const {
+  if (rs_->block()) {
+    const auto& c = rs_->column(col);
+    if (c.ind[index_] == SQL_NULL_DATA) { out.clear(); return false; }
+    const std::string_view v = bound_string(c, index_, col, rs_->scratch(col));
+    out.assign(v.data(), v.size());
+    return true;
   }
-  if (ind == SQL_NULL_DATA) return std::nullopt;
-  if (ind <= (SQLLEN)sizeof(buf)) {
-    // ind includes terminating null; exclude it
-    if (ind > 0) {
-      result.assign(buf, buf + std::max<SQLLEN>(0, ind - 1));
-    }
-    return result;
-  }
-  // Need to fetch remaining parts
-  result.assign(buf, buf + (sizeof(buf) - 1)); // drop terminator
-  SQLLEN totalExpected = ind - 1; // exclude terminator
-  while ((SQLLEN)result.size() < totalExpected) {
-    char chunk[512];
-    rc = SQLGetData(load_handle<HSTMT>(hstmt_), static_cast<SQLUSMALLINT>(col), SQL_C_CHAR,
-                    chunk, sizeof(chunk), &got);
-    if (!(rc == SQL_SUCCESS || rc == SQL_SUCCESS_WITH_INFO)) {
-      throw_diag(SQL_HANDLE_STMT, load_handle<HSTMT>(hstmt_), "SQLGetData(string-continued)");
-    }
-    if (got == SQL_NULL_DATA) break;
-    if (got > 0) {
-      // got includes terminating null in last chunk
-      size_t toAppend = static_cast<size_t>(got);
-      if ((SQLLEN)(result.size() + toAppend) >= totalExpected + 1) {
-        // last chunk, remove terminator
-        if (toAppend > 0) --toAppend;
-      }
-      result.append(chunk, chunk + toAppend);
+  return get_data_into(rs_->hstmt(), col, SQL_C_CHAR, out, "SQLGetData(string)");
+}
+
+std::optional<std::string_view> Connection::Row::getStringView(int col) const {
+  std::string& scratch = rs_->scratch(col);
+  if (rs_->block()) {
+    const auto& c = rs_->column(col);
+    if (c.ind[index_] == SQL_NULL_DATA) return std::nullopt;
+    return bound_string(c, index_, col, scratch);
+  }
+  if (!get_data_into(rs_->hstmt(), col, SQL_C_CHAR, scratch, "SQLGetData(string)")) return std::nullopt;
+  return std::string_view(scratch);
+}
+
+std::optional<std::string_view> Connection::Row::getBytes(int col) const {
+  std::string& scratch = rs_->scratch(col);
+  if (rs_->block()) {
+    const auto& c = rs_->column(col);
+    if (c.ind[index_] == SQL_NULL_DATA) return std::nullopt;
+    if (c.c_type == SQL_C_CHAR || c.c_type == SQL_C_BINARY) return bound_text(c, index_, col);
+    return bound_string(c, index_, col, scratch); // numbers: their text form
+  }
+  if (!get_data_into(rs_->hstmt(), col, SQL_C_BINARY, scratch, "SQLGetData(bytes)")) return std::nullopt;
+  return std::string_view(scratch);
+}
+
+std::optional<std::uint64_t> Connection::Row::readLob(int col, const LobSink& sink, std::size_t chunk_size) const {
+  if (chunk_size == 0) throw std::invalid_argument("readLob: chunk_size must be positive");
+  std::string& scratch = rs_->scratch(col);
+  if (rs_->block()) {
+    // Bound columns are never LOBs, but keep the contract for any column
+    const auto& c = rs_->column(col);
+    if (c.ind[index_] == SQL_NULL_DATA) return std::nullopt;
+    const std::string_view v = (c.c_type == SQL_C_CHAR || c.c_type == SQL_C_BINARY)
+        ? bound_text(c, index_, col)
+        : bound_string(c, index_, col, scratch);
+    std::uint64_t total = 0;
+    for (std::size_t pos = 0; pos < v.size(); pos += chunk_size) {
+      const std::string_view chunk = v.substr(pos, chunk_size);
+      total += chunk.size();
+      if (!sink(chunk)) break;
     }
-    if (rc == SQL_SUCCESS) break; // all data retrieved
+    return total;
   }
-  return result;
+
+  std::int16_t sql_type = 0;
+  if (col >= 1 && static_cast<std::size_t>(col) <= descriptor().size()) sql_type = descriptor().column(col).sql_type;
+  const bool binary = sql_type == SQL_BLOB || sql_type == SQL_BINARY || sql_type == SQL_VARBINARY ||
+                      sql_type == SQL_LONGVARBINARY;
+  const SQLSMALLINT c_type = binary ? SQL_C_BINARY : SQL_C_CHAR;
+  const std::size_t term = binary ? 0 : 1; // SQL_C_CHAR chunks are NUL-terminated
+  scratch.resize(chunk_size + term);
+
+  const HSTMT hstmt = rs_->hstmt();
+  std::uint64_t total = 0;
+  for (bool first = true;; first = false) {
+    SQLLEN ind = 0;
+    SQLRETURN rc = SQLGetData(hstmt, static_cast<SQLUSMALLINT>(col), c_type, scratch.data(),
+                              static_cast<SQLLEN>(scratch.size()), &ind);
+    if (rc == SQL_NO_DATA) {
+      if (first) return std::nullopt;
+      break;
+    }
+    if (!(rc == SQL_SUCCESS || rc == SQL_SUCCESS_WITH_INFO)) throw_diag(SQL_HANDLE_STMT, hstmt, "SQLGetData(lob)");
+    if (ind == SQL_NULL_DATA) return std::nullopt;
+    // The indicator is the length remaining before this call
+    const bool last = ind != SQL_NO_TOTAL && static_cast<std::size_t>(ind) <= chunk_size;
+    const std::size_t n = last ? static_cast<std::size_t>(ind) : chunk_size;
+    if (n > 0) {
+      total += n;
+      if (!sink(std::string_view(scratch.data(), n))) break;
+    }
+    if (last) break;
+  }
+  return total;
 }
 
 } // namespace db2
@@ -0,0 +1,223 @@
+// group_commit.h
+// Group commit for write-heavy handlers: writes submitted by many callers are
+// applied on one dedicated connection and committed together, so a window of
+// N small writes costs one log force instead of N. Header-only.
+//
+// Each write still succeeds or fails on its own. If any write in a group
+// throws, the group is rolled back and its writes are re-run one transaction
+// each, so one bad request does not fail its neighbours.
+//
+// Example:
+//
+//   auto conn = std::make_shared<db2::Connection>();
+//   conn->connect_with_conn_str(conn_str);
+//   db2::GroupCommitter orders(conn, {.window = std::chrono::milliseconds(2), .max_batch = 128});
+//   ...
+//   auto done = orders.submit([&](db2::Connection& c) {
+//     c.execute("INSERT INTO APP.ORDERS (ID, ITEM) VALUES (?, ?)", {db2::Param{id}, db2::Param{item}});
+//   });
+//   done.get(); // returns once the write is committed; rethrows its error otherwise
+
+#pragma once
+
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <functional>
+#include <future>
+#include <iterator>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "db2/db2.hpp"
+
+namespace db2 {
+
+// `Conn` needs begin()/commit()/rollback() (db2::Connection in production).
+template <class Conn>
+class BasicGroupCommitter {
+public:
+  using Write = std::function<void(Conn&)>;
+
+  struct Options {
+    // How long the first write of a group waits for company before the
+    // group is committed. Bounds the latency added to each write.
+    std::chrono::microseconds window{1000};
+    // A group is committed as soon as it has this many writes
+    std::size_t max_batch = 64;
+  };
+
+  struct Stats {
+    std::uint64_t commits{0};   // successful group commits
+    std::uint64_t writes{0};    // writes committed (grouped or individually)
+    std::uint64_t fallbacks{0}; // groups re-run one write per transaction
+  };
+
+  BasicGroupCommitter(std::shared_ptr<Conn> conn, Options options)
+      : conn_(std::move(conn)), options_(options) {
+    if (!conn_) throw std::invalid_argument("BasicGroupCommitter: connection must not be null");
+    if (options_.max_batch == 0) options_.max_batch = 1;
+    thread_ = std::jthread([this] { run(); });
+  }
+
+  explicit BasicGroupCommitter(std::shared_ptr<Conn> conn)
+      : BasicGroupCommitter(std::move(conn), Options{}) {}
+
+  BasicGroupCommitter(const BasicGroupCommitter&) = delete;
+  BasicGroupCommitter& operator=(const BasicGroupCommitter&) = delete;
+
+  // Commits everything already submitted before returning
+  ~BasicGroupCommitter() {
+    {
+      std::scoped_lock lk(mtx_);
+      stop_ = true;
+    }
+    cv_.notify_all();
+    if (thread_.joinable()) thread_.join();
+  }
+
+  // Queue a write. The future becomes ready once the transaction containing
+  // it has committed, or holds the exception that made it fail. Writes run
+  // on the committer's thread, so they must not wait on each other.
+  std::future<void> submit(Write write) {
+    Pending pending{std::move(write), {}};
+    auto future = pending.done.get_future();
+    {
+      std::scoped_lock lk(mtx_);
+      if (stop_) throw std::runtime_error("BasicGroupCommitter: shutting down");
+      queue_.push_back(std::move(pending));
+    }
+    cv_.notify_all();
+    return future;
+  }
+
+  Stats stats() const {
+    std::scoped_lock lk(mtx_);
+    return stats_;
+  }
+
+private:
+  struct Pending {
+    Write write;
+    std::promise<void> done;
+  };
+
+  void run() {
+    std::vector<Pending> group;
+    for (;;) {
+      {
+        std::unique_lock lk(mtx_);
+        cv_.wait(lk, [&] { return stop_ || !queue_.empty(); });
+        if (queue_.empty()) return; // stopping and drained
+        // Hold the window open for more writes unless the group is full
+        const auto deadline = std::chrono::steady_clock::now() + options_.window;
+        cv_.wait_until(lk, deadline, [&] { return stop_ || queue_.size() >= options_.max_batch; });
+        const std::size_t n = std::min(queue_.size(), options_.max_batch);
+        group.assign(std::make_move_iterator(queue_.begin()), std::make_move_iterator(queue_.begin() + n));
+        queue_.erase(queue_.begin(), queue_.begin() + n);
+      }
+      flush(group);
+      group.clear();
+    }
+  }
+
+  void flush(std::vector<Pending>& group) {
+    Conn& conn = *conn_;
+    std::exception_ptr write_error;
+    try {
+      conn.begin();
+    } catch (...) {
+      fail_all(group, std::current_exception());
+      return;
+    }
+    try {
+      for (auto& p : group) p.write(conn);
+    } catch (...) {
+      write_error = std::current_exception();
+    }
+    if (write_error) {
+      conn.rollback();
+      if (group.size() == 1) {
+        group.front().done.set_exception(write_error);
+        return;
+      }
+      run_individually(group);
+      return;
+    }
+    try {
+      conn.commit();
+    } catch (...) {
+      // The outcome of a failed commit is unknown to us (e.g. the link
+      // dropped mid-commit), so the writes are not retried
+      fail_all(group, std::current_exception());
+      return;
+    }
+    {
+      std::scoped_lock lk(mtx_);
+      ++stats_.commits;
+      stats_.writes += group.size();
+    }
+    for (auto& p : group) p.done.set_value();
+  }
+
+  void run_individually(std::vector<Pending>& group) {
+    {
+      std::scoped_lock lk(mtx_);
+      ++stats_.fallbacks;
+    }
+    Conn& conn = *conn_;
+    for (auto& p : group) {
+      std::exception_ptr error;
+      try {
+        conn.begin();
+        try {
+          p.write(conn);
+        } catch (...) {
+          error = std::current_exception();
+        }
+        if (error) {
+          conn.rollback();
+        } else {
+          conn.commit();
+        }
+      } catch (...) {
+        error = std::current_exception();
+      }
+      if (error) {
+        p.done.set_exception(error);
+        continue;
+      }
+      {
+        std::scoped_lock lk(mtx_);
+        ++stats_.writes;
+      }
+      p.done.set_value();
+    }
+  }
+
+  static void fail_all(std::vector<Pending>& group, const std::exception_ptr& error) {
+    for (auto& p : group) p.done.set_exception(error);
+  }
+
+  std::shared_ptr<Conn> conn_;
+  Options options_;
+
+  mutable std::mutex mtx_;
+  std::condition_variable cv_;
+  std::vector<Pending> queue_;
+  bool stop_{false};
+  Stats stats_{};
+
+  std::jthread thread_; // last: joined before the members above are destroyed
+};
+
+using GroupCommitter = BasicGroupCommitter<Connection>;
+
+} // namespace db2
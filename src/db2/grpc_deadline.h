@@ -0,0 +1,51 @@
+// grpc_deadline.h
+// Derive DB2 query timeouts from gRPC server deadlines. Header-only; include
+// from server code that already depends on grpc++.
+//
+// Usage:
+//
+//   auto options = db2::options_for_deadline(*context);
+//   if (!options) {
+//     reactor->Finish(grpc::Status(grpc::StatusCode::DEADLINE_EXCEEDED, "deadline exceeded"));
+//     return reactor;
+//   }
+//   auto rows = conn->query_as<std::tuple<std::string>>(sql, params, *options);
+
+#pragma once
+
+#include <chrono>
+#include <optional>
+
+#include <grpcpp/server_context.h>
+
+#include "db2/db2.hpp"
+
+namespace db2 {
+
+// Time left before the RPC's deadline. Returns zero when the RPC has no
+// deadline, and std::nullopt once the deadline has passed (the client has
+// given up, so the DB work should be skipped).
+inline std::optional<std::chrono::milliseconds> remaining_until_deadline(const grpc::ServerContextBase& context) {
+  using Clock = std::chrono::system_clock;
+  const Clock::time_point deadline = context.deadline();
+  if (deadline == Clock::time_point::max()) return std::chrono::milliseconds::zero();
+  const auto remaining = std::chrono::ceil<std::chrono::milliseconds>(deadline - Clock::now());
+  if (remaining <= std::chrono::milliseconds::zero()) return std::nullopt;
+  return remaining;
+}
+
+// `base` with its timeout capped at the RPC's remaining time, or std::nullopt
+// if the deadline has already passed. The CLI rounds timeouts up to whole
+// seconds, so a query may overrun a sub-second remainder slightly.
+inline std::optional<QueryOptions> options_for_deadline(const grpc::ServerContextBase& context,
+                                                        QueryOptions base = {}) {
+  const auto remaining = remaining_until_deadline(context);
+  if (!remaining) return std::nullopt;
+  if (*remaining > std::chrono::milliseconds::zero() &&
+      (base.timeout <= std::chrono::milliseconds::zero() || *remaining < base.timeout)) {
+    base.timeout = *remaining;
+  }
+  return base;
+}
+
+} // namespace db2
@@ -0,0 +1,348 @@
+// result_cache.h
+// Opt-in cache for query results that are read far more often than they
+// change (reference data, hot lookups repeated within seconds). Header-only;
+// sits in front of a db2::Connection or a pool of them.
+//
+// Entries are keyed by the normalized SQL (sql::anonymize) plus the exact
+// parameter values and the result type, live for a TTL, and are evicted least
+// recently used first once the cache exceeds its byte budget. Concurrent
+// misses on the same key run the query once; the other callers wait for and
+// share that result. Writers invalidate by table tag.
+//
+// Example:
+//
+//   db2::ResultCache cache({.max_bytes = 32 << 20, .ttl = std::chrono::seconds(10)});
+//   auto rows = cache.query_as<std::tuple<std::string, double>>(
+//       *pool, "SELECT NAME, PRICE FROM APP.ITEMS WHERE ID = ?", {db2::Param{id}},
+//       {.tags = {"APP.ITEMS"}});
+//   ...
+//   conn->execute("UPDATE APP.ITEMS SET PRICE = ? WHERE ID = ?", {db2::Param{price}, db2::Param{id}});
+//   cache.invalidate("APP.ITEMS");
+//
+// Results are shared, immutable snapshots: callers get a
+// std::shared_ptr<const std::vector<Tuple>> that stays valid after eviction.
+
+#pragma once
+
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <future>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <tuple>
+#include <type_traits>
+#include <typeinfo>
+#include <unordered_map>
+#include <unordered_set>
+#include <utility>
+#include <variant>
+#include <vector>
+
+#include "db2/db2.hpp"
+#include "resource/resource_pool.hpp"
+#include "util/sql_util.h"
+
+namespace db2 {
+
+namespace result_cache_detail {
+
+// Approximate heap footprint of a cached value, used for the byte budget.
+// Counts element storage and out-of-line string buffers, not allocator
+// overhead.
+inline std::size_t heap_bytes(const std::string& s) noexcept {
+  // Short strings live inside the object, up to a default string's capacity
+  static const std::size_t in_object = std::string().capacity();
+  return s.capacity() > in_object ? s.capacity() + 1 : 0;
+}
+
+// Scalars, and anything else without a dedicated overload
+template <class T>
+std::size_t heap_bytes(const T&) noexcept {
+  return 0;
+}
+
+template <class T>
+std::size_t heap_bytes(const std::optional<T>& v) noexcept;
+template <class... Ts>
+std::size_t heap_bytes(const std::tuple<Ts...>& t) noexcept;
+template <class T>
+std::size_t heap_bytes(const std::vector<T>& v) noexcept;
+
+template <class T>
+std::size_t heap_bytes(const std::optional<T>& v) noexcept {
+  return v ? heap_bytes(*v) : 0;
+}
+
+template <class... Ts>
+std::size_t heap_bytes(const std::tuple<Ts...>& t) noexcept {
+  return std::apply([](const auto&... e) { return (std::size_t{0} + ... + heap_bytes(e)); }, t);
+}
+
+template <class T>
+std::size_t heap_bytes(const std::vector<T>& v) noexcept {
+  std::size_t n = v.capacity() * sizeof(T);
+  if constexpr (!std::is_trivially_copyable_v<T>) {
+    for (const auto& e : v) n += heap_bytes(e);
+  }
+  return n;
+}
+
+// Appends a self-delimiting encoding of `p` to `key`: type tag, then the
+// value bytes (text is length-prefixed). Owned and borrowed strings encode
+// alike since they bind identically.
+inline void append_param(std::string& key, const Param& p) {
+  auto raw = [&key](const void* data, std::size_t size) { key.append(static_cast<const char*>(data), size); };
+  std::visit(
+      [&](const auto& v) {
+        using V = std::decay_t<decltype(v)>;
+        if constexpr (std::is_same_v<V, std::nullptr_t>) {
+          key.push_back('N');
+        } else if constexpr (std::is_same_v<V, std::string> || std::is_same_v<V, std::string_view>) {
+          key.push_back('S');
+          const std::uint64_t size = v.size();
+          raw(&size, sizeof(size));
+          key.append(v.data(), v.size());
+        } else {
+          key.push_back(std::is_same_v<V, int32_t> ? 'i' : std::is_same_v<V, int64_t> ? 'l' : 'd');
+          raw(&v, sizeof(v));
+        }
+      },
+      p.value);
+}
+
+} // namespace result_cache_detail
+
+class ResultCache {
+public:
+  using Clock = std::chrono::steady_clock;
+
+  struct Options {
+    // Budget for cached results (approximate heap bytes, see heap_bytes).
+    // Results larger than this are returned but not cached.
+    std::size_t max_bytes = std::size_t{64} << 20;
+    // Default lifetime of an entry
+    std::chrono::milliseconds ttl{5000};
+  };
+
+  // Per-query settings
+  struct Entry {
+    // Lifetime of this result; nullopt => Options::ttl
+    std::optional<std::chrono::milliseconds> ttl{};
+    // Invalidation tags, usually the tables the query reads
+    std::vector<std::string> tags{};
+  };
+
+  struct Stats {
+    std::uint64_t hits{0};
+    std::uint64_t misses{0};    // queries actually run
+    std::uint64_t coalesced{0}; // misses that waited for another caller's query
+    std::uint64_t evictions{0}; // entries dropped for the byte budget
+    std::size_t bytes{0};
+    std::size_t entries{0};
+  };
+
+  explicit ResultCache(Options options)
+      : options_(options) {}
+
+  ResultCache()
+      : ResultCache(Options{}) {}
+
+  ResultCache(const ResultCache&) = delete;
+  ResultCache& operator=(const ResultCache&) = delete;
+
+  // Cached Connection::query_as. `conn` is only used on a miss.
+  template <class Tuple, class Conn>
+  std::shared_ptr<const std::vector<Tuple>> query_as(Conn& conn, std::string_view sql,
+                                                     const std::vector<Param>& params = {},
+                                                     const Entry& entry = {}) {
+    return get_or_load<std::vector<Tuple>>(sql, params, entry, [&] {
+      return conn.template query_as<Tuple>(sql, params);
+    });
+  }
+
+  // Same, acquiring a pooled connection only on a miss
+  template <class Tuple, class Conn>
+  std::shared_ptr<const std::vector<Tuple>> query_as(resource::ResourcePool<Conn>& pool, std::string_view sql,
+                                                     const std::vector<Param>& params = {},
+                                                     const Entry& entry = {}) {
+    return get_or_load<std::vector<Tuple>>(sql, params, entry, [&] {
+      auto conn = pool.acquire();
+      return conn->template query_as<Tuple>(sql, params);
+    });
+  }
+
+  // General form: returns the cached T for (sql, params), or runs `load()`
+  // (returning T) once for all concurrent callers and caches its result.
+  // If `load` throws, every waiting caller gets the exception and nothing is
+  // cached.
+  template <class T, class Load>
+  std::shared_ptr<const T> get_or_load(std::string_view sql, const std::vector<Param>& params, const Entry& entry,
+                                       Load&& load) {
+    std::string key = make_key(sql, params, typeid(T));
+    std::shared_ptr<Flight> flight;
+    bool leader = false;
+    std::uint64_t epoch = 0;
+    {
+      std::scoped_lock lk(mtx_);
+      if (auto it = entries_.find(key); it != entries_.end()) {
+        if (Clock::now() < it->second.expires) {
+          lru_.splice(lru_.begin(), lru_, it->second.lru_pos);
+          ++stats_.hits;
+          return std::static_pointer_cast<const T>(it->second.value);
+        }
+        erase_locked(it);
+      }
+      if (auto it = flights_.find(key); it != flights_.end()) {
+        flight = it->second;
+        ++stats_.coalesced;
+      } else {
+        flight = std::make_shared<Flight>();
+        flight->result = flight->done.get_future().share();
+        flight->tags = entry.tags;
+        flights_.emplace(key, flight);
+        leader = true;
+        epoch = epoch_;
+        ++stats_.misses;
+      }
+    }
+    if (!leader) return std::static_pointer_cast<const T>(flight->result.get());
+
+    std::shared_ptr<const T> value;
+    try {
+      value = std::make_shared<const T>(load());
+    } catch (...) {
+      {
+        std::scoped_lock lk(mtx_);
+        remove_flight_locked(key, flight);
+      }
+      flight->done.set_exception(std::current_exception());
+      throw;
+    }
+    {
+      std::scoped_lock lk(mtx_);
+      remove_flight_locked(key, flight);
+      // An invalidation while the query ran may have raced with a write the
+      // result does not reflect: hand it to the waiters but do not keep it
+      if (epoch == epoch_) {
+        const std::size_t bytes = key.size() + sizeof(T) + result_cache_detail::heap_bytes(*value) + kEntryOverhead;
+        insert_locked(std::move(key), value, bytes, entry);
+      }
+    }
+    flight->done.set_value(value);
+    return value;
+  }
+
+  // Drop every entry tagged `tag`; queries in flight for it are not cached
+  void invalidate(std::string_view tag) {
+    std::scoped_lock lk(mtx_);
+    ++epoch_;
+    if (auto it = tags_.find(std::string(tag)); it != tags_.end()) {
+      auto keys = std::move(it->second);
+      tags_.erase(it);
+      for (const auto& k : keys) {
+        if (auto e = entries_.find(k); e != entries_.end()) erase_locked(e);
+      }
+    }
+    // Later callers must not join a query that may predate the write
+    std::erase_if(flights_, [&](const auto& f) {
+      const auto& t = f.second->tags;
+      return std::find(t.begin(), t.end(), tag) != t.end();
+    });
+  }
+
+  void clear() {
+    std::scoped_lock lk(mtx_);
+    ++epoch_;
+    entries_.clear();
+    lru_.clear();
+    tags_.clear();
+    flights_.clear();
+    stats_.bytes = 0;
+  }
+
+  Stats stats() const {
+    std::scoped_lock lk(mtx_);
+    Stats s = stats_;
+    s.entries = entries_.size();
+    return s;
+  }
+
+private:
+  // Bookkeeping per entry (map node, LRU node, tag sets), roughly
+  static constexpr std::size_t kEntryOverhead = 128;
+
+  struct Flight {
+    std::promise<std::shared_ptr<const void>> done;
+    std::shared_future<std::shared_ptr<const void>> result;
+    std::vector<std::string> tags;
+  };
+
+  struct Slot {
+    std::shared_ptr<const void> value;
+    std::size_t bytes{0};
+    Clock::time_point expires;
+    std::vector<std::string> tags;
+    std::list<std::string>::iterator lru_pos;
+  };
+
+  using EntryMap = std::unordered_map<std::string, Slot>;
+
+  static std::string make_key(std::string_view sql, const std::vector<Param>& params, const std::type_info& type) {
+    std::string key = sql::anonymize(std::string(sql));
+    key.push_back('\0');
+    key.append(type.name());
+    key.push_back('\0');
+    for (const auto& p : params) result_cache_detail::append_param(key, p);
+    return key;
+  }
+
+  void insert_locked(std::string key, std::shared_ptr<const void> value, std::size_t bytes, const Entry& entry) {
+    if (bytes > options_.max_bytes) return;
+    if (auto it = entries_.find(key); it != entries_.end()) erase_locked(it);
+    while (stats_.bytes + bytes > options_.max_bytes && !lru_.empty()) {
+      erase_locked(entries_.find(lru_.back()));
+      ++stats_.evictions;
+    }
+    lru_.push_front(key);
+    Slot slot{std::move(value), bytes, Clock::now() + entry.ttl.value_or(options_.ttl), entry.tags, lru_.begin()};
+    for (const auto& t : entry.tags) tags_[t].insert(key);
+    entries_.emplace(std::move(key), std::move(slot));
+    stats_.bytes += bytes;
+  }
+
+  void erase_locked(EntryMap::iterator it) {
+    for (const auto& t : it->second.tags) {
+      if (auto tag = tags_.find(t); tag != tags_.end()) {
+        tag->second.erase(it->first);
+        if (tag->second.empty()) tags_.erase(tag);
+      }
+    }
+    lru_.erase(it->second.lru_pos);
+    stats_.bytes -= it->second.bytes;
+    entries_.erase(it);
+  }
+
+  void remove_flight_locked(const std::string& key, const std::shared_ptr<Flight>& flight) {
+    // The slot may already have been dropped by invalidate()
+    if (auto it = flights_.find(key); it != flights_.end() && it->second == flight) flights_.erase(it);
+  }
+
+  Options options_;
+
+  mutable std::mutex mtx_;
+  EntryMap entries_;
+  std::list<std::string> lru_; // most recently used first
+  std::unordered_map<std::string, std::unordered_set<std::string>> tags_;
+  std::unordered_map<std::string, std::shared_ptr<Flight>> flights_;
+  std::uint64_t epoch_{0}; // bumped by every invalidation
+  Stats stats_{};
+};
+
+} // namespace db2
@@ -0,0 +1,258 @@
+// routing_pool.h
+// Read/write routing over a primary pool and read-only replica pools (e.g. a
+// DB2 HADR standby with reads on standby enabled). Header-only; builds on
+// resource::ResourcePool.
+//
+// Writes always go to the primary. Reads go to a replica whose measured
+// replay lag is within the caller's staleness bound, round-robin across
+// eligible replicas, and fall back to the primary when no replica qualifies
+// or none has a connection available without waiting.
+//
+// Example:
+//
+//   auto router = db2::make_routing_pool(primary_conn_str, {standby_conn_str}, /*pool_size=*/8);
+//   auto conn = router->acquire_read();                 // standby if fresh enough
+//   auto rows = conn->query_as<std::tuple<std::string>>("SELECT ...");
+//   router->acquire_write()->execute("UPDATE ...");     // always the primary
+
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "db2/db2.hpp"
+#include "resource/resource_pool.hpp"
+
+namespace db2 {
+
+// Replay lag of a DB2 HADR standby, measured on a connection to it: how far
+// the replayed log trails the primary's log (MON_GET_HADR, whole seconds).
+// Returns std::nullopt when HADR reports nothing (not a standby).
+inline std::optional<std::chrono::milliseconds> hadr_replay_lag(Connection& standby) {
+  auto rows = standby.query_as<std::tuple<std::optional<std::int64_t>>>(
+      "SELECT TIMESTAMPDIFF(2, CHAR(PRIMARY_LOG_TIME - STANDBY_REPLAY_LOG_TIME)) "
+      "FROM TABLE(MON_GET_HADR(NULL)) FETCH FIRST 1 ROW ONLY");
+  if (rows.empty() || !std::get<0>(rows.front())) return std::nullopt;
+  return std::chrono::seconds(*std::get<0>(rows.front()));
+}
+
+// `Conn` is the pooled resource type (db2::Connection in production).
+template <class Conn>
+class BasicRoutingPool {
+public:
+  using Pool = resource::ResourcePool<Conn>;
+  using SharedPtr = typename Pool::SharedPtr;
+  // Measures a replica's lag on one of its connections; std::nullopt means
+  // unknown, which makes the replica ineligible until the next refresh
+  using LagProbe = std::function<std::optional<std::chrono::milliseconds>(Conn&)>;
+
+  struct Replica {
+    std::string name;
+    std::shared_ptr<Pool> pool;
+  };
+
+  struct Options {
+    // Default staleness bound for acquire_read()
+    std::chrono::milliseconds max_lag{5000};
+    // How often a background thread re-measures replica lag and lets replicas
+    // that failed to connect back in; 0 => only when refresh_lag() is called
+    std::chrono::milliseconds refresh_interval{1000};
+    // Lag measurement; empty => replicas are assumed current
+    LagProbe lag_probe{};
+  };
+
+  struct Stats {
+    std::uint64_t replica_reads{0};
+    std::uint64_t primary_reads{0}; // reads that fell back to the primary
+    std::uint64_t writes{0};
+  };
+
+  BasicRoutingPool(std::shared_ptr<Pool> primary, std::vector<Replica> replicas, Options options)
+      : primary_(std::move(primary)), options_(std::move(options)) {
+    if (!primary_) throw std::invalid_argument("BasicRoutingPool: primary pool must not be null");
+    replicas_.reserve(replicas.size());
+    for (auto& r : replicas) {
+      if (!r.pool) throw std::invalid_argument("BasicRoutingPool: replica pool must not be null");
+      replicas_.push_back(std::make_unique<ReplicaState>(std::move(r)));
+    }
+    if (!replicas_.empty()) {
+      if (options_.lag_probe) refresh_lag();
+      // Also needed without a probe: the refresh re-admits failed replicas
+      if (options_.refresh_interval > std::chrono::milliseconds::zero()) {
+        refresher_ = std::jthread([this](std::stop_token stop) { refresh_loop(stop); });
+      }
+    }
+  }
+
+  BasicRoutingPool(std::shared_ptr<Pool> primary, std::vector<Replica> replicas)
+      : BasicRoutingPool(std::move(primary), std::move(replicas), Options{}) {}
+
+  BasicRoutingPool(const BasicRoutingPool&) = delete;
+  BasicRoutingPool& operator=(const BasicRoutingPool&) = delete;
+
+  ~BasicRoutingPool() {
+    if (refresher_.joinable()) {
+      refresher_.request_stop();
+      {
+        std::scoped_lock lk(refresh_mtx_);
+      }
+      refresh_cv_.notify_all();
+      refresher_.join();
+    }
+  }
+
+  // Connection to the primary (blocking, like Pool::acquire)
+  SharedPtr acquire_write() {
+    writes_.fetch_add(1, std::memory_order_relaxed);
+    return primary_->acquire();
+  }
+
+  // Connection for a read-only query whose data may be up to `max_lag` old.
+  // Never waits on a replica: if no eligible replica has a connection ready
+  // (or creating one fails), the read goes to the primary.
+  SharedPtr acquire_read(std::chrono::milliseconds max_lag) {
+    const std::size_t n = replicas_.size();
+    const std::size_t start = n ? next_.fetch_add(1, std::memory_order_relaxed) : 0;
+    for (std::size_t i = 0; i < n; ++i) {
+      auto& r = *replicas_[(start + i) % n];
+      if (!r.eligible(max_lag)) continue;
+      try {
+        if (auto conn = r.replica.pool->try_acquire()) {
+          replica_reads_.fetch_add(1, std::memory_order_relaxed);
+          return conn;
+        }
+      } catch (...) {
+        // Could not connect: skip this replica until the next lag refresh
+        r.healthy.store(false, std::memory_order_relaxed);
+      }
+    }
+    primary_reads_.fetch_add(1, std::memory_order_relaxed);
+    return primary_->acquire();
+  }
+
+  SharedPtr acquire_read() { return acquire_read(options_.max_lag); }
+
+  // Re-measure every replica's lag now (also run by the background thread)
+  void refresh_lag() {
+    for (auto& r : replicas_) {
+      std::optional<std::chrono::milliseconds> lag;
+      bool ok = false;
+      try {
+        if (!options_.lag_probe) {
+          lag = std::chrono::milliseconds::zero();
+        } else {
+          auto conn = r->replica.pool->try_acquire();
+          // Every connection busy: the replica is serving reads, keep the
+          // previous measurement rather than waiting for one
+          if (!conn) continue;
+          lag = options_.lag_probe(*conn);
+        }
+        ok = lag.has_value();
+      } catch (...) {
+        ok = false;
+      }
+      r->lag_ms.store(lag ? lag->count() : kUnknownLag, std::memory_order_relaxed);
+      r->healthy.store(ok, std::memory_order_relaxed);
+    }
+  }
+
+  // Last measured lag of replica `index`, or std::nullopt if unknown/unhealthy
+  std::optional<std::chrono::milliseconds> replica_lag(std::size_t index) const {
+    const auto& r = *replicas_.at(index);
+    const auto lag = r.lag_ms.load(std::memory_order_relaxed);
+    if (!r.healthy.load(std::memory_order_relaxed) || lag == kUnknownLag) return std::nullopt;
+    return std::chrono::milliseconds(lag);
+  }
+
+  std::size_t replica_count() const noexcept { return replicas_.size(); }
+  const std::shared_ptr<Pool>& primary() const noexcept { return primary_; }
+  const std::shared_ptr<Pool>& replica_pool(std::size_t index) const { return replicas_.at(index)->replica.pool; }
+
+  Stats stats() const noexcept {
+    return Stats{replica_reads_.load(std::memory_order_relaxed), primary_reads_.load(std::memory_order_relaxed),
+                 writes_.load(std::memory_order_relaxed)};
+  }
+
+private:
+  static constexpr std::int64_t kUnknownLag = -1;
+
+  struct ReplicaState {
+    explicit ReplicaState(Replica r)
+        : replica(std::move(r)) {}
+
+    bool eligible(std::chrono::milliseconds max_lag) const noexcept {
+      const auto lag = lag_ms.load(std::memory_order_relaxed);
+      return healthy.load(std::memory_order_relaxed) && lag != kUnknownLag && lag <= max_lag.count();
+    }
+
+    Replica replica;
+    // Replicas start out eligible with zero lag; the first refresh (run in
+    // the constructor when a probe is configured) corrects that
+    std::atomic<std::int64_t> lag_ms{0};
+    std::atomic<bool> healthy{true};
+  };
+
+  void refresh_loop(std::stop_token stop) {
+    std::unique_lock lk(refresh_mtx_);
+    while (!stop.stop_requested()) {
+      refresh_cv_.wait_for(lk, options_.refresh_interval, [&] { return stop.stop_requested(); });
+      if (stop.stop_requested()) break;
+      lk.unlock();
+      refresh_lag();
+      lk.lock();
+    }
+  }
+
+  std::shared_ptr<Pool> primary_;
+  std::vector<std::unique_ptr<ReplicaState>> replicas_;
+  Options options_;
+
+  std::atomic<std::size_t> next_{0};
+  std::atomic<std::uint64_t> replica_reads_{0};
+  std::atomic<std::uint64_t> primary_reads_{0};
+  std::atomic<std::uint64_t> writes_{0};
+
+  std::mutex refresh_mtx_;
+  std::condition_variable refresh_cv_;
+  std::jthread refresher_; // last: stopped before the members above are destroyed
+};
+
+using RoutingPool = BasicRoutingPool<Connection>;
+
+// Routing pool over db2::Connection pools built from connection strings,
+// each with up to `pool_size` connections and HADR replay lag probing.
+inline std::shared_ptr<RoutingPool> make_routing_pool(const std::string& primary_conn_str,
+                                                      const std::vector<std::string>& replica_conn_strs,
+                                                      std::size_t pool_size,
+                                                      RoutingPool::Options options = {}) {
+  auto make_pool = [pool_size](std::string conn_str) {
+    return RoutingPool::Pool::create(
+        pool_size,
+        [conn_str = std::move(conn_str)] {
+          auto c = std::make_unique<Connection>();
+          c->connect_with_conn_str(conn_str);
+          return c;
+        },
+        [](const Connection& c) { return c.is_connected(); });
+  };
+  std::vector<RoutingPool::Replica> replicas;
+  for (std::size_t i = 0; i < replica_conn_strs.size(); ++i) {
+    replicas.push_back({"replica-" + std::to_string(i), make_pool(replica_conn_strs[i])});
+  }
+  if (!options.lag_probe) options.lag_probe = [](Connection& c) { return hadr_replay_lag(c); };
+  return std::make_shared<RoutingPool>(make_pool(primary_conn_str), std::move(replicas), std::move(options));
+}
+
+} // namespace db2
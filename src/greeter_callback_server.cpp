@@ -17,6 +17,8 @@
 #include "absl/strings/str_format.h"
 
 #include "db2/db2.hpp"
+#include "db2/async_executor.h"
+#include "db2/grpc_deadline.h"
 #include "resource/resource_pool.hpp"
 
 #ifdef BAZEL_BUILD
@@ -53,8 +55,14 @@ class GreeterServiceImpl final : public Greeter::CallbackService {
  public:
   using Db2Pool = resource::ResourcePool<db2::Connection>;
 
+  // DB2 work runs on the executor's threads; callback threads never block
   explicit GreeterServiceImpl(std::shared_ptr<Db2Pool> pool)
-      : pool_(std::move(pool)) {}
+      : pool_(std::move(pool)),
+        db_(pool_ ? std::make_unique<db2::AsyncExecutor>(pool_, db2::AsyncExecutor::Options{
+                                                                    .thread_count = 8,
+                                                                    .max_queue = 1024,
+                                                                    .name = "db2-async"})
+                  : nullptr) {}
 
   ServerUnaryReactor* SayHello(CallbackServerContext* context,
                                const HelloRequest* request,
@@ -69,30 +77,52 @@ class GreeterServiceImpl final : public Greeter::CallbackService {
       return reactor;
     }
 
-    // Acquire a DB2 Connection from the shared pool just for demonstration
-    // It will be returned to the pool automatically when it goes out of scope.
-    std::shared_ptr<db2::Connection> conn;
-    if (pool_) {
-      try {
-        conn = pool_->acquire();
-        spdlog::info("Acquired DB2 resource from pool. in_use={}, idle={}",
-                     pool_->in_use(), pool_->idle_size());
-        // Demonstration only: no actual DB operations are performed.
-      } catch (const std::exception& e) {
-        spdlog::error("Failed to acquire DB2 resource: {}", e.what());
-      }
-    } else {
+    if (!db_) {
       spdlog::warn("DB2 pool not available; proceeding without DB resource.");
+      reply->set_message("Hello " + request->name());
+      reactor->Finish(Status::OK);
+      return reactor;
     }
 
-    std::string prefix("Hello ");
-    reply->set_message(prefix + request->name());
-
-    reactor->Finish(Status::OK);
+    // Acquire a DB2 Connection from the shared pool on a DB worker thread
+    // just for demonstration; the RPC is finished from the completion callback.
+    // request/reply stay valid until Finish is called.
+    bool queued = db_->post(
+        [pool = pool_, context](db2::Connection&) {
+          // The request may have waited in the DB queue: skip the work if the
+          // client's deadline already passed. Queries would pass the options on
+          // so SQL_ATTR_QUERY_TIMEOUT ends them at the deadline.
+          auto options = db2::options_for_deadline(*context);
+          if (!options) return false;
+          spdlog::info("Acquired DB2 resource from pool. in_use={}, idle={}",
+                       pool->in_use(), pool->idle_size());
+          // Demonstration only: no actual DB operations are performed.
+          return true;
+        },
+        [reactor, request, reply](db2::AsyncResult<bool> result) {
+          if (!result.ok()) {
+            try {
+              result.get();
+            } catch (const std::exception& e) {
+              spdlog::error("Failed to acquire DB2 resource: {}", e.what());
+            }
+          } else if (!*result.value) {
+            spdlog::warn("Deadline passed before DB2 work started.");
+            reactor->Finish(Status(grpc::StatusCode::DEADLINE_EXCEEDED, "Deadline exceeded"));
+            return;
+          }
+          reply->set_message("Hello " + request->name());
+          reactor->Finish(Status::OK);
+        });
+    if (!queued) {
+      spdlog::error("DB2 request queue full; rejecting request.");
+      reactor->Finish(Status(grpc::StatusCode::RESOURCE_EXHAUSTED, "DB2 request queue full"));
+    }
     return reactor;
   }
  private:
   std::shared_ptr<Db2Pool> pool_;
+  std::unique_ptr<db2::AsyncExecutor> db_;
 };
 
 void RunServer(uint16_t port) {
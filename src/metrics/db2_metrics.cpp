@@ -0,0 +1,126 @@
+#include "db2_metrics.h"
+
+#include <cctype>
+#include <vector>
+
+#include "util/sql_util.h"
+
+namespace {
+
+// Bucket vectors shared by every statement's series
+const std::vector<double>& phase_buckets() {
+    static const std::vector<double> buckets =
+        {0.0001, 0.0005, 0.001, 0.005, 0.01, 0.025, 0.05, 0.1, 0.25, 0.5, 1.0, 2.5, 5.0, 10.0};
+    return buckets;
+}
+
+const std::vector<double>& rows_buckets() {
+    static const std::vector<double> buckets =
+        {0, 1, 10, 100, 1000, 10000, 100000, 1000000};
+    return buckets;
+}
+
+} // namespace
+
+Db2Metrics::Db2Metrics(const std::shared_ptr<prometheus::Registry>& registry,
+                       std::size_t max_statements,
+                       std::size_t max_fingerprint_length)
+    : phase_histogram_family(prometheus::BuildHistogram()
+                                 .Name("db2_statement_phase_duration_seconds")
+                                 .Help("DB2 statement prepare/execute/fetch duration in seconds")
+                                 .Register(*registry)),
+      rows_histogram_family(prometheus::BuildHistogram()
+                                .Name("db2_statement_rows_fetched")
+                                .Help("Rows fetched per DB2 result set")
+                                .Register(*registry)),
+      error_counter_family(prometheus::BuildCounter()
+                               .Name("db2_statement_errors_total")
+                               .Help("Failed DB2 calls by statement and SQLSTATE")
+                               .Register(*registry)),
+      reconnect_counter_family(prometheus::BuildCounter()
+                                   .Name("db2_reconnects_total")
+                                   .Help("DB2 reconnect attempts after a lost link")
+                                   .Register(*registry)),
+      max_statements_(max_statements),
+      max_fingerprint_length_(max_fingerprint_length),
+      reconnects_ok_(reconnect_counter_family.Add({{"result", "ok"}})),
+      reconnects_failed_(reconnect_counter_family.Add({{"result", "failed"}})) {}
+
+std::string Db2Metrics::fingerprint(std::string_view sql, std::size_t max_length) {
+    const std::string anonymized = sql::anonymize(std::string(sql));
+    std::string out;
+    out.reserve(anonymized.size());
+    for (char c : anonymized) {
+        if (std::isspace(static_cast<unsigned char>(c))) {
+            if (!out.empty() && out.back() != ' ') out += ' ';
+        } else {
+            out += c;
+        }
+    }
+    if (!out.empty() && out.back() == ' ') out.pop_back();
+    if (out.size() > max_length) out.resize(max_length);
+    return out;
+}
+
+Db2Metrics::Statement& Db2Metrics::statement_locked(std::string_view sql) {
+    if (auto it = statements_.find(sql); it != statements_.end()) return it->second;
+
+    // The raw-text map only caches fingerprinting; callers that inline
+    // literals into SQL would grow it without bound, so start over instead
+    if (statements_.size() >= max_statements_ * 4) statements_.clear();
+
+    std::string fp = fingerprint(sql, max_fingerprint_length_);
+    auto series = by_fingerprint_.find(fp);
+    if (series == by_fingerprint_.end()) {
+        // The last of the max_statements_ series is reserved for "other"
+        if (by_fingerprint_.size() + 1 >= max_statements_) fp = "other";
+        series = by_fingerprint_.find(fp);
+    }
+    if (series == by_fingerprint_.end()) {
+        auto phase = [&](const char* name) {
+            return &phase_histogram_family.Add({{"statement", fp}, {"phase", name}}, phase_buckets());
+        };
+        Statement s{fp, phase("prepare"), phase("execute"), phase("fetch"),
+                    &rows_histogram_family.Add({{"statement", fp}}, rows_buckets())};
+        series = by_fingerprint_.emplace(fp, std::move(s)).first;
+    }
+    return statements_.emplace(std::string(sql), series->second).first->second;
+}
+
+void Db2Metrics::on_phase(std::string_view sql, Phase phase, std::chrono::nanoseconds elapsed,
+                          std::uint64_t rows) noexcept {
+    try {
+        std::scoped_lock lk(mtx_);
+        auto& s = statement_locked(sql);
+        const double seconds = std::chrono::duration<double>(elapsed).count();
+        switch (phase) {
+        case Phase::Prepare:
+            s.prepare->Observe(seconds);
+            break;
+        case Phase::Execute:
+            s.execute->Observe(seconds);
+            break;
+        case Phase::Fetch:
+            s.fetch->Observe(seconds);
+            s.rows->Observe(static_cast<double>(rows));
+            break;
+        }
+    } catch (...) {
+        // Metrics must never fail the statement
+    }
+}
+
+void Db2Metrics::on_error(std::string_view sql, std::string_view sqlstate) noexcept {
+    try {
+        std::scoped_lock lk(mtx_);
+        const auto& s = statement_locked(sql);
+        error_counter_family
+            .Add({{"statement", s.fingerprint}, {"sqlstate", sqlstate.empty() ? "unknown" : std::string(sqlstate)}})
+            .Increment();
+    } catch (...) {
+    }
+}
+
+void Db2Metrics::on_reconnect(bool ok) noexcept {
+    (ok ? reconnects_ok_ : reconnects_failed_).Increment();
+}
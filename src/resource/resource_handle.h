@@ -1,5 +1,6 @@
 #pragma once
 
+#include <algorithm>
 #include <condition_variable>
 #include <functional>
 #include <memory>
@@ -30,7 +31,10 @@ struct PoolConfig {
     std::chrono::milliseconds acquire_timeout{30000}; // 30 seconds
     bool validate_on_acquire = true;
     bool validate_on_return = true;
-    size_t max_idle_time_seconds = 300; // 5 minutes
+    size_t max_idle_time_seconds = 300; // 5 minutes; enforced by maintenance, 0 disables eviction
+    size_t min_idle = 0;                // idle resources kept ready by maintenance
+    bool validate_idle = false;         // validate idle resources during maintenance
+    std::chrono::milliseconds maintenance_interval{0}; // > 0 starts the maintenance thread (opt-in)
 };
 
 /**
@@ -138,6 +142,8 @@ private:
  * - Timeout support for acquire operations
  * - RAII-based resource handles
  * - Graceful shutdown with proper cleanup
+ * - Opt-in background maintenance (maintenance_interval): idle eviction,
+ *   min-idle floor, idle validation
  * - No memory leaks, deadlocks, or race conditions
  *
  * @tparam T The resource type to pool
@@ -176,6 +182,10 @@ public:
             throw PoolException("Initial size cannot exceed max size");
         }
 
+        if (config_.min_idle > config_.max_size) {
+            throw PoolException("Min idle cannot exceed max size");
+        }
+
         // Pre-allocate initial resources (no lock needed during construction)
         try {
             for (size_t i = 0; i < config_.initial_size; ++i) {
@@ -197,7 +207,7 @@ public:
                     }
                 }
 
-                available_.push_back(std::move(resource));
+                available_.push_back(makeIdle(std::move(resource)));
                 ++total_created_;
             }
         } catch (const std::exception& e) {
@@ -205,6 +215,10 @@ public:
             shutdown();
             throw PoolException(std::string("Failed to initialize pool: ") + e.what());
         }
+
+        if (config_.maintenance_interval > std::chrono::milliseconds::zero()) {
+            maintenance_thread_ = std::thread(&ResourcePool::maintenanceLoop, this);
+        }
     }
 
     /**
@@ -212,6 +226,7 @@ public:
      */
     ~ResourcePool() {
         shutdown();
+        stopMaintenance();
     }
 
     // Non-copyable and non-movable (manage single resource pool instance)
@@ -243,7 +258,7 @@ public:
 
             // Try to get an available resource (LIFO - most recently used)
             if (!available_.empty()) {
-                auto resource = std::move(available_.back());
+                auto resource = std::move(available_.back().resource);
                 available_.pop_back();
 
                 // Validate outside mutex to avoid blocking other threads
@@ -337,7 +352,7 @@ public:
         }
 
         if (!available_.empty()) {
-            auto resource = std::move(available_.back());
+            auto resource = std::move(available_.back().resource);
             available_.pop_back();
 
             // Validate outside mutex
@@ -436,10 +451,12 @@ public:
      *
      * Immediately destroys all idle resources and prevents new acquisitions.
      * In-use resources will be destroyed when returned (via RAII).
-     * Does not block - returns immediately after cleanup.
+     * Does not wait for in-use resources, but joins the maintenance thread,
+     * so it can wait for one in-flight maintenance pass (factory or
+     * validator calls) to finish.
      */
     void shutdown() {
-        std::vector<std::unique_ptr<T>> to_destroy;
+        std::vector<IdleEntry> to_destroy;
         size_t leaked_count = 0;
 
         {
@@ -461,12 +478,13 @@ public:
 
         // Notify all waiting threads
         cv_.notify_all();
+        stopMaintenance();
 
         // Destroy idle resources outside mutex
-        for (auto& resource : to_destroy) {
+        for (auto& entry : to_destroy) {
             if (destroyer_) {
                 try {
-                    destroyer_(*resource);
+                    destroyer_(*entry.resource);
                 } catch (...) {
                     // Swallow exceptions during cleanup
                 }
@@ -480,7 +498,9 @@ public:
     /**
      * @brief Shutdown and wait for all resources to be returned
      *
-     * Blocks until all resources are returned or timeout expires.
+     * Blocks until all resources are returned or timeout expires, then
+     * joins the maintenance thread, which can add one in-flight maintenance
+     * pass on top of the timeout.
      * Use this when you need to ensure all resources are properly released.
      *
      * @param timeout Maximum time to wait for resources
@@ -503,17 +523,18 @@ public:
         });
 
         // Clean up all available resources
-        std::vector<std::unique_ptr<T>> to_destroy = std::move(available_);
+        std::vector<IdleEntry> to_destroy = std::move(available_);
         available_.clear();
         size_t leaked = all_returned ? 0 : (total_created_ - to_destroy.size());
 
         lock.unlock();
+        stopMaintenance();
 
         // Destroy outside mutex
-        for (auto& resource : to_destroy) {
+        for (auto& entry : to_destroy) {
             if (destroyer_) {
                 try {
-                    destroyer_(*resource);
+                    destroyer_(*entry.resource);
                 } catch (...) {}
             }
         }
@@ -522,26 +543,47 @@ public:
     }
 
     /**
-     * @brief Force immediate shutdown without waiting
+     * @brief Force immediate shutdown without waiting for in-use resources
      *
+     * Still joins the maintenance thread, so it can wait for one in-flight
+     * maintenance pass to finish.
      * Warning: Resources currently in use will become invalid
      */
     void forceShutdown() {
-        std::lock_guard<std::mutex> lock(mutex_);
-        shutdown_ = true;
-        cv_.notify_all();
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            shutdown_ = true;
+            cv_.notify_all();
 
-        while (!available_.empty()) {
-            auto resource = std::move(available_.front());
-            available_.pop();
-            if (destroyer_) {
-                try {
-                    destroyer_(*resource);
-                } catch (...) {}
+            while (!available_.empty()) {
+                auto resource = std::move(available_.back().resource);
+                available_.pop_back();
+                if (destroyer_) {
+                    try {
+                        destroyer_(*resource);
+                    } catch (...) {}
+                }
             }
+
+            total_created_ = 0;
         }
+        stopMaintenance();
+    }
 
-        total_created_ = 0;
+    /**
+     * @brief Run one maintenance pass on the calling thread
+     *
+     * Evicts resources idle longer than max_idle_time_seconds (never below
+     * min_idle), validates idle resources if validate_idle is set, then
+     * creates resources until min_idle are idle. The maintenance thread calls
+     * this every maintenance_interval.
+     */
+    void runMaintenance() {
+        evictIdle();
+        if (config_.validate_idle && validator_) {
+            validateIdle();
+        }
+        fillMinIdle();
     }
 
 private:
@@ -582,7 +624,7 @@ private:
                 should_notify = true;
             } else {
                 // Return to pool (LIFO - push to back)
-                available_.push_back(std::move(resource));
+                available_.push_back(makeIdle(std::move(resource)));
                 should_notify = true;
             }
         }
@@ -600,6 +642,201 @@ private:
         }
     }
 
+    /**
+     * @brief An idle resource with the times it was returned and last validated
+     */
+    struct IdleEntry {
+        std::unique_ptr<T> resource;
+        std::chrono::steady_clock::time_point since;
+        std::chrono::steady_clock::time_point checked;
+    };
+
+    static IdleEntry makeIdle(std::unique_ptr<T> resource) {
+        const auto now = std::chrono::steady_clock::now();
+        return IdleEntry{std::move(resource), now, now};
+    }
+
+    bool isValid(const T& resource) const {
+        try {
+            return validator_(resource);
+        } catch (...) {
+            return false;
+        }
+    }
+
+    void destroyResource(std::unique_ptr<T> resource) {
+        if (resource && destroyer_) {
+            try {
+                destroyer_(*resource);
+            } catch (...) {}
+        }
+    }
+
+    /**
+     * @brief Destroy resources idle longer than max_idle_time_seconds
+     *
+     * available_ is LIFO, so the longest-idle resources are mostly at the
+     * front; the whole list is scanned so order never hides an expired one.
+     */
+    void evictIdle() {
+        if (config_.max_idle_time_seconds == 0) {
+            return;
+        }
+        const auto cutoff = std::chrono::steady_clock::now() - std::chrono::seconds(config_.max_idle_time_seconds);
+        std::vector<IdleEntry> evicted;
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            if (shutdown_) {
+                return;
+            }
+            const size_t evictable =
+                available_.size() > config_.min_idle ? available_.size() - config_.min_idle : 0;
+            auto keep = available_.begin();
+            for (auto it = available_.begin(); it != available_.end(); ++it) {
+                if (evicted.size() < evictable && it->since < cutoff) {
+                    evicted.push_back(std::move(*it));
+                } else {
+                    if (keep != it) {
+                        *keep = std::move(*it);
+                    }
+                    ++keep;
+                }
+            }
+            available_.erase(keep, available_.end());
+            total_created_ -= evicted.size();
+        }
+        if (!evicted.empty()) {
+            cv_.notify_all(); // Freed slots
+        }
+        for (auto& entry : evicted) {
+            destroyResource(std::move(entry.resource));
+        }
+    }
+
+    /**
+     * @brief Validate idle resources one at a time outside the mutex
+     *
+     * The rest stay available meanwhile; valid resources go back at the
+     * position their original idle time sorts to (longest idle at the front).
+     */
+    void validateIdle() {
+        const auto pass_start = std::chrono::steady_clock::now();
+        while (true) {
+            IdleEntry entry;
+            {
+                std::lock_guard<std::mutex> lock(mutex_);
+                if (shutdown_) {
+                    return;
+                }
+                auto it = std::find_if(available_.begin(), available_.end(),
+                                       [&](const IdleEntry& e) { return e.checked < pass_start; });
+                if (it == available_.end()) {
+                    return;
+                }
+                entry = std::move(*it);
+                available_.erase(it);
+            }
+
+            bool valid = isValid(*entry.resource);
+            entry.checked = std::chrono::steady_clock::now();
+
+            std::unique_ptr<T> to_destroy;
+            {
+                std::lock_guard<std::mutex> lock(mutex_);
+                if (shutdown_ || !valid) {
+                    --total_created_;
+                    to_destroy = std::move(entry.resource);
+                } else {
+                    auto pos = std::upper_bound(available_.begin(), available_.end(), entry.since,
+                                                [](const auto& t, const IdleEntry& e) { return t < e.since; });
+                    available_.insert(pos, std::move(entry));
+                }
+            }
+            cv_.notify_one();
+            destroyResource(std::move(to_destroy));
+        }
+    }
+
+    /**
+     * @brief Create resources until min_idle are idle (within max_size)
+     *
+     * Runs the factory off the request path; stops at the first failure and
+     * retries on the next pass.
+     */
+    void fillMinIdle() {
+        while (true) {
+            {
+                std::lock_guard<std::mutex> lock(mutex_);
+                if (shutdown_ || available_.size() >= config_.min_idle ||
+                    total_created_ >= config_.max_size) {
+                    return;
+                }
+                ++total_created_; // Reserve slot
+            }
+
+            std::unique_ptr<T> resource;
+            try {
+                resource = factory_();
+            } catch (...) {
+                resource = nullptr;
+            }
+            if (!resource || (validator_ && !isValid(*resource))) {
+                {
+                    std::lock_guard<std::mutex> rollback_lock(mutex_);
+                    --total_created_;
+                }
+                cv_.notify_one();
+                destroyResource(std::move(resource));
+                return;
+            }
+
+            std::unique_ptr<T> to_destroy;
+            {
+                std::lock_guard<std::mutex> lock(mutex_);
+                if (shutdown_) {
+                    --total_created_;
+                    to_destroy = std::move(resource);
+                } else {
+                    available_.push_back(makeIdle(std::move(resource)));
+                }
+            }
+            cv_.notify_one();
+            destroyResource(std::move(to_destroy));
+        }
+    }
+
+    void maintenanceLoop() {
+        std::unique_lock<std::mutex> lock(mutex_);
+        while (!maintenance_cv_.wait_for(lock, config_.maintenance_interval, [this] { return shutdown_; })) {
+            lock.unlock();
+            try {
+                runMaintenance();
+            } catch (...) {
+                // Keep maintaining; the next pass retries
+            }
+            lock.lock();
+        }
+    }
+
+    /**
+     * @brief Stop and join the maintenance thread (after shutdown_ is set)
+     */
+    void stopMaintenance() {
+        std::thread worker;
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            worker = std::move(maintenance_thread_);
+        }
+        maintenance_cv_.notify_all();
+        if (worker.joinable()) {
+            if (worker.get_id() == std::this_thread::get_id()) {
+                worker.detach();
+            } else {
+                worker.join();
+            }
+        }
+    }
+
     FactoryFunc factory_;
     ValidatorFunc validator_;
     DestroyFunc destroyer_;
@@ -607,9 +844,12 @@ private:
 
     mutable std::mutex mutex_;
     std::condition_variable cv_;
-    std::vector<std::unique_ptr<T>> available_;  // LIFO for hot/cold pattern
+    std::vector<IdleEntry> available_;  // LIFO for hot/cold pattern
     size_t total_created_;
     bool shutdown_;
+
+    std::condition_variable maintenance_cv_; // Wakes the maintenance thread on shutdown
+    std::thread maintenance_thread_;
 };
 
 } // namespace resource_pool
\ No newline at end of file
@@ -3,8 +3,15 @@
 // Features:
 // - Single resource type per pool; supports any type via C++ templates
 // - Bounded pool size with blocking acquire and timed acquire
+// - Optional sharded idle lists (per-thread home shard, stealing when empty)
+//   so many threads can check out and return without a shared lock
+// - Non-blocking async_acquire: queued waiters are completed on an executor
 // - Return-to-pool via std::shared_ptr custom deleter (RAII)
-// - Optional validator to health-check resources on return/acquire
+// - Allocation-free, move-only PooledRef handles for hot paths (acquire_ref)
+// - Optional validator to health-check resources on return/acquire, with
+//   throttling policies (idle time, every N uses, on reported errors only)
+// - Optional background maintenance: idle eviction, min-idle floor and
+//   validation of idle resources off the request path
 // - Safe shutdown to wake waiters and drain idle resources
 //
 // Typical usage with db2::Connection:
@@ -27,44 +34,216 @@
 //   auto conn = pool->acquire();
 //   conn->execute("CREATE TABLE ...");
 //
+// On hot paths prefer acquire_ref(): the returned PooledRef is move-only and
+// costs no heap allocation per checkout (no shared_ptr control block). It can
+// still be turned into a SharedPtr when the resource must be shared:
+//
+//   auto ref = pool->acquire_ref();
+//   ref->execute("UPDATE ...");
+//   auto shared = std::move(ref).share(); // allocates a control block
+//
+// A validator that costs a round trip (SELECT 1 FROM SYSIBM.SYSDUMMY1) should
+// not run on every checkout; validate only connections that sat idle a while
+// or were reported broken:
+//
+//   pool->set_validation_policy({.idle_longer_than = std::chrono::seconds(30)});
+//   ...
+//   try { conn->execute(...); } catch (const db2::Error&) { conn.mark_failed(); throw; }
+//
+// Background maintenance closes resources idle for too long (so idle DB2
+// connections stop holding server agents), keeps a floor of ready ones so
+// request threads don't pay connect latency, and health-checks idle ones:
+//
+//   pool->start_maintenance({.interval = std::chrono::seconds(30),
+//                            .max_idle_time = std::chrono::minutes(5),
+//                            .min_idle = 2,
+//                            .validate_idle = true});
+//
+// A pool shared by many threads (e.g. every gRPC worker) can split its idle
+// resources into shards; each thread returns to and takes from its own shard
+// first and steals from the others only when that shard is empty:
+//
+//   auto pool = resource::ResourcePool<Connection>::create(
+//       32, factory, validator, /*warmup_size=*/0,
+//       /*shards=*/std::thread::hardware_concurrency());
+//
+// From code that must not block (gRPC reactors, completion-queue loops), wait
+// for a resource without parking the thread. The callback runs on `executor`
+// (anything with post(std::function<void()>), e.g. worker::WorkerPool::Executor):
+//
+//   pool->async_acquire(db_workers.get_executor(),
+//       [reactor](auto conn, std::exception_ptr error) {
+//         if (!conn) { reactor->Finish(error ? kDbError : kDbBusy); return; }
+//         ...
+//       },
+//       std::chrono::steady_clock::now() + std::chrono::milliseconds(200));
+//
 // Note: For the RAII deleter to safely return resources to the pool, the pool
 // must be owned by a std::shared_ptr (created via ResourcePool::create()).
+// Dropping the last std::shared_ptr shuts the pool down; outstanding
+// PooledRefs keep its memory alive until they are released.
 
 #pragma once
 
+#include <algorithm>
+#include <atomic>
+#include <concepts>
 #include <condition_variable>
 #include <chrono>
 #include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <exception>
 #include <functional>
+#include <future>
 #include <memory>
 #include <mutex>
+#include <optional>
 #include <stdexcept>
+#include <thread>
+#include <type_traits>
 #include <utility>
 #include <vector>
 
 namespace resource {
 
+template <class T>
+class ResourcePool;
+
+// Bookkeeping that travels with a pooled resource through checkouts; drives
+// ResourcePool::ValidationPolicy
+struct ResourceUsage {
+  std::chrono::steady_clock::time_point validated{}; // last validator run
+  std::uint32_t uses_since_validated = 0;            // checkouts since then
+  bool failed = false;                               // reported by the user
+};
+
+// Move-only handle to a resource checked out of a ResourcePool; returns it to
+// the pool on destruction or reset(). Holds the resource and the pool by raw
+// pointer and keeps the pool alive through the pool's intrusive handle count,
+// so checking out and returning never allocates.
+template <class T>
+class PooledRef {
+public:
+  PooledRef() noexcept = default;
+  PooledRef(const PooledRef&) = delete;
+  PooledRef& operator=(const PooledRef&) = delete;
+
+  PooledRef(PooledRef&& other) noexcept
+    : pool_(std::exchange(other.pool_, nullptr)),
+      resource_(std::exchange(other.resource_, nullptr)),
+      usage_(other.usage_) {}
+
+  PooledRef& operator=(PooledRef&& other) noexcept {
+    if (this != &other) {
+      reset();
+      pool_ = std::exchange(other.pool_, nullptr);
+      resource_ = std::exchange(other.resource_, nullptr);
+      usage_ = other.usage_;
+    }
+    return *this;
+  }
+
+  ~PooledRef() { reset(); }
+
+  T* get() const noexcept { return resource_; }
+  T& operator*() const noexcept { return *resource_; }
+  T* operator->() const noexcept { return resource_; }
+  explicit operator bool() const noexcept { return resource_ != nullptr; }
+
+  // Report that using the resource failed (e.g. a lost connection); it is
+  // validated on return even if the pool's policy would skip that
+  void mark_failed() noexcept { usage_.failed = true; }
+
+  // Return the resource to the pool now
+  void reset() noexcept {
+    if (!resource_) return;
+    auto* pool = std::exchange(pool_, nullptr);
+    pool->release_raw(std::exchange(resource_, nullptr), usage_);
+    pool->unref();
+  }
+
+  // Convert to the pool's SharedPtr (one control-block allocation); the
+  // resource is then returned when the last copy is destroyed
+  std::shared_ptr<T> share() && {
+    if (!resource_) return nullptr;
+    auto* pool = std::exchange(pool_, nullptr);
+    auto shared = pool->wrap_shared(std::unique_ptr<T>(std::exchange(resource_, nullptr)), usage_);
+    pool->unref();
+    return shared;
+  }
+
+private:
+  friend class ResourcePool<T>;
+
+  // Pre-condition: the caller already counted this handle in pool->refs_
+  PooledRef(ResourcePool<T>* pool, T* resource, ResourceUsage usage) noexcept
+    : pool_(pool), resource_(resource), usage_(usage) {}
+
+  ResourcePool<T>* pool_{nullptr};
+  T* resource_{nullptr};
+  ResourceUsage usage_{};
+};
+
 template <class T>
 class ResourcePool : public std::enable_shared_from_this<ResourcePool<T>> {
 public:
   using value_type = T;
   using UniquePtr = std::unique_ptr<T>;
   using SharedPtr = std::shared_ptr<T>;
+  using Ref       = PooledRef<T>;
   using Factory   = std::function<UniquePtr()>;                   // create new T
   using Validator = std::function<bool(const T&)>;                // check health
+  using Clock     = std::chrono::steady_clock;
+
+  // Completion of async_acquire: (resource, nullptr) on success,
+  // (nullptr, nullptr) when the deadline passed first, and (nullptr, error)
+  // when creating the resource failed, the pool shut down, or the executor
+  // rejected the completion. Must not throw.
+  using AcquireCallback = std::function<void(SharedPtr, std::exception_ptr)>;
+
+  // When acquire and release run the validator. The default (all fields
+  // zero/false) validates on every acquire and release. Setting any field
+  // switches to: acquire validates when an enabled trigger fires, release
+  // validates only resources reported with mark_failed().
+  struct ValidationPolicy {
+    // Acquire validates resources idle longer than this; zero => off
+    std::chrono::milliseconds idle_longer_than{0};
+    // Acquire validates every Nth checkout of a resource; zero => off
+    std::uint32_t every_n_uses = 0;
+    // Acquire never validates; only mark_failed() resources are checked
+    bool on_error_only = false;
+  };
+
+  // Background maintenance settings, see start_maintenance()
+  struct Maintenance {
+    // Time between passes; zero starts no thread (call run_maintenance())
+    std::chrono::milliseconds interval{30000};
+    // Idle resources older than this are destroyed; zero never evicts
+    std::chrono::milliseconds max_idle_time{0};
+    // Idle resources kept ready: eviction stops at this floor, and missing
+    // ones are created (within max_size) by the maintenance pass
+    std::size_t min_idle = 0;
+    // Run the validator over idle resources each pass
+    bool validate_idle = false;
+  };
 
   // Create a pool wrapped in std::shared_ptr to enable RAII return via deleter
   // Optional warmup_size pre-allocates up to N resources eagerly (validated)
   // before returning. If creation/validation fails during warm-up, this
   // function throws and the pool is not created.
+  // `shards` > 1 splits the idle resources into that many lists with their
+  // own locks; 0 is treated as 1 (a single list).
   static std::shared_ptr<ResourcePool> create(std::size_t max_size,
                                               Factory factory,
                                               Validator validator = {},
-                                              std::size_t warmup_size = 0) {
+                                              std::size_t warmup_size = 0,
+                                              std::size_t shards = 1) {
     if (!factory) {
       throw std::invalid_argument("ResourcePool: factory must not be empty");
     }
-    auto sp = std::shared_ptr<ResourcePool>(new ResourcePool(max_size, std::move(factory), std::move(validator)));
+    auto sp = std::shared_ptr<ResourcePool>(
+        new ResourcePool(max_size, std::move(factory), std::move(validator), shards), &ResourcePool::retire);
     if (warmup_size > 0) {
       sp->perform_warmup(warmup_size);
     }
@@ -84,6 +263,20 @@ public:
     return acquire_until(Clock::time_point::max());
   }
 
+  // Allocation-free counterparts of acquire(), acquire_for() and try_acquire()
+  Ref acquire_ref() {
+    return make_ref(checkout_until(Clock::time_point::max()));
+  }
+
+  template <class Rep, class Period>
+  Ref acquire_ref_for(const std::chrono::duration<Rep, Period>& timeout) {
+    return make_ref(checkout_until(Clock::now() + std::chrono::duration_cast<Clock::duration>(timeout)));
+  }
+
+  Ref try_acquire_ref() {
+    return make_ref(checkout_now());
+  }
+
   // Try to acquire within a duration; returns nullptr on timeout.
   template <class Rep, class Period>
   SharedPtr acquire_for(const std::chrono::duration<Rep, Period>& timeout) {
@@ -113,56 +306,272 @@ public:
 
   // Non-throwing immediate try_acquire; returns nullptr if not available and cannot create.
   SharedPtr try_acquire() {
-    std::unique_lock<std::mutex> lk(mtx_);
-    if (shutting_down_) return nullptr;
+    return wrap_shared(checkout_now());
+  }
 
-    if (!idle_.empty()) {
-      return make_shared_from_idle_locked(lk);
+  // Acquire without blocking the caller. If a resource is idle or may be
+  // created, `callback` is invoked on `executor` with it (creation and
+  // validation also run there). Otherwise the request is queued and completed
+  // by the next release, in FIFO order among async waiters and ahead of
+  // blocked acquire() callers; at `deadline` it is completed with nullptr.
+  // `executor` needs post(std::function<void()>) returning bool (false =>
+  // rejected, and the callback then runs on the thread that tried to post).
+  template <class Executor>
+  void async_acquire(Executor executor, AcquireCallback callback,
+                     Clock::time_point deadline = Clock::time_point::max()) {
+    if (!callback) {
+      throw std::invalid_argument("ResourcePool: async_acquire callback must not be empty");
     }
-    if (total_ < max_size_) {
-      // will create outside lock
-      ++total_;
-      lk.unlock();
-      return make_shared_from_factory();
+    enqueue_async(AsyncWaiter{std::move(callback), make_post(std::move(executor)), deadline});
+  }
+
+  // Future form of async_acquire: resolves to the resource, to nullptr at the
+  // deadline, or to the creation/shutdown error.
+  template <class Executor>
+  std::future<SharedPtr> async_acquire(Executor executor, Clock::time_point deadline = Clock::time_point::max()) {
+    auto promise = std::make_shared<std::promise<SharedPtr>>();
+    auto future = promise->get_future();
+    async_acquire(std::move(executor),
+                  [promise](SharedPtr resource, std::exception_ptr error) {
+                    if (error) {
+                      promise->set_exception(error);
+                    } else {
+                      promise->set_value(std::move(resource));
+                    }
+                  },
+                  deadline);
+    return future;
+  }
+
+  // Change when the validator runs; takes effect for subsequent checkouts
+  void set_validation_policy(const ValidationPolicy& policy) noexcept {
+    validate_idle_after_.store(policy.idle_longer_than.count(), std::memory_order_relaxed);
+    validate_every_n_.store(policy.every_n_uses, std::memory_order_relaxed);
+    validate_on_error_only_.store(policy.on_error_only, std::memory_order_relaxed);
+    if (policy.idle_longer_than > std::chrono::milliseconds::zero()) {
+      // Resources returned before tracking started have no return time and
+      // are validated on their next checkout
+      track_idle_time_.store(true);
+    }
+  }
+
+  // SharedPtr counterpart of PooledRef::mark_failed(); no-op for pointers
+  // not handed out by a ResourcePool<T>
+  static void mark_failed(const SharedPtr& resource) noexcept {
+    if (auto* deleter = std::get_deleter<Deleter>(resource)) {
+      deleter->usage.failed = true;
+    }
+  }
+
+  // Enable idle-time tracking and start a background thread running
+  // run_maintenance() every `options.interval`. May be called once.
+  void start_maintenance(Maintenance options) {
+    std::lock_guard<std::mutex> lk(mtx_);
+    if (shutting_down_.load()) {
+      throw std::runtime_error("ResourcePool is shutting down");
+    }
+    if (maintenance_) {
+      throw std::logic_error("ResourcePool: maintenance already started");
+    }
+    maintenance_ = options;
+    // Resources parked so far were not timestamped; their idle time starts now
+    const auto now = Clock::now();
+    for (auto& shard : shards_) {
+      std::lock_guard<std::mutex> slk(shard.mtx);
+      for (auto& entry : shard.idle) entry.since = now;
+    }
+    track_idle_time_.store(true);
+    if (options.interval > std::chrono::milliseconds::zero()) {
+      maintenance_thread_ = std::thread(&ResourcePool::maintenance_loop, this->weak_from_this(),
+                                        maintenance_timer_, options.interval);
+    }
+  }
+
+  // One maintenance pass on the calling thread: evict expired idle
+  // resources, validate the remaining ones if configured, then create
+  // resources up to min_idle. No-op before start_maintenance().
+  void run_maintenance() {
+    std::optional<Maintenance> options;
+    {
+      std::lock_guard<std::mutex> lk(mtx_);
+      options = maintenance_;
+    }
+    if (!options || shutting_down_.load()) return;
+    if (options->max_idle_time > std::chrono::milliseconds::zero()) {
+      evict_idle(Clock::now() - options->max_idle_time, options->min_idle);
+    }
+    if (options->validate_idle && validator_) {
+      validate_idle();
+    }
+    while (!shutting_down_.load() && idle_count_.load() < options->min_idle && try_reserve()) {
+      UniquePtr u;
+      try {
+        u = create_resource();
+      } catch (...) {
+        return; // slot already given back; retry next pass
+      }
+      put_back(make_entry(std::move(u))); // to a waiter, if one showed up meanwhile
     }
-    return nullptr;
   }
 
   // Stop the pool: wake all waiters and destroy all idle resources.
+  // Queued async waiters are completed with an error.
   // In-use resources will be destroyed when their shared_ptrs go out of scope.
   void shutdown() {
-    std::vector<UniquePtr> to_destroy;
+    std::deque<AsyncWaiter> waiters;
+    std::thread expiry;
+    std::thread maintenance;
     {
       std::lock_guard<std::mutex> lk(mtx_);
-      if (shutting_down_) return;
-      shutting_down_ = true;
-      to_destroy.swap(idle_);
+      if (shutting_down_.load()) return;
+      shutting_down_.store(true);
+      {
+        std::lock_guard<std::mutex> alk(async_->mtx);
+        waiters.swap(async_->waiters);
+        async_->queued.store(0);
+        async_->stopped = true;
+      }
+      expiry = std::move(expiry_thread_);
+      maintenance = std::move(maintenance_thread_);
+      {
+        std::lock_guard<std::mutex> mlk(maintenance_timer_->mtx);
+        maintenance_timer_->stopped = true;
+      }
     }
     cv_.notify_all();
+    async_->cv.notify_all();
+    maintenance_timer_->cv.notify_all();
+    // The last reference may be dropped on the expiry or maintenance thread
+    // itself (by a callback, or by the pass's own reference); both only touch
+    // shared state once stopped, so let them finish
+    for (auto* t : {&expiry, &maintenance}) {
+      if (!t->joinable()) continue;
+      if (t->get_id() == std::this_thread::get_id()) {
+        t->detach();
+      } else {
+        t->join();
+      }
+    }
+    for (auto& w : waiters) {
+      fail_waiter(std::move(w), std::make_exception_ptr(std::runtime_error("ResourcePool is shutting down")));
+    }
     // Destroy outside lock
-    to_destroy.clear();
+    destroy_idle();
   }
 
   // Observability helpers (approximate under concurrency)
   std::size_t max_size() const noexcept { return max_size_; }
-  std::size_t total() const noexcept { std::lock_guard<std::mutex> lk(mtx_); return total_; }
-  std::size_t idle_size() const noexcept { std::lock_guard<std::mutex> lk(mtx_); return idle_.size(); }
-  std::size_t in_use() const noexcept { std::lock_guard<std::mutex> lk(mtx_); return total_ - idle_.size(); }
+  std::size_t shards() const noexcept { return shards_.size(); }
+  std::size_t total() const noexcept { return total_.load(); }
+  std::size_t idle_size() const noexcept { return idle_count_.load(); }
+  std::size_t in_use() const noexcept {
+    const std::size_t total = total_.load();
+    const std::size_t idle = idle_count_.load();
+    return total > idle ? total - idle : 0;
+  }
+  std::size_t async_waiting() const noexcept { return async_->queued.load(); }
 
 private:
-  using Clock = std::chrono::steady_clock;
+  // Posts a task to the waiter's executor; false if the executor rejected it
+  using Post = std::function<bool(std::function<void()>)>;
+
+  struct AsyncWaiter {
+    AcquireCallback callback;
+    Post post;
+    Clock::time_point deadline;
+  };
 
-  explicit ResourcePool(std::size_t max_size, Factory factory, Validator validator)
+  // Queued async waiters. Shared with the expiry thread, which only ever
+  // touches this (never the pool), so it can outlive a pool destroyed from
+  // one of its callbacks. Lock order: mtx_, then AsyncQueue::mtx.
+  struct AsyncQueue {
+    mutable std::mutex mtx;
+    std::condition_variable cv;
+    std::deque<AsyncWaiter> waiters;
+    std::atomic<std::size_t> queued{0}; // waiters.size(), readable without mtx
+    bool stopped{false};
+  };
+
+  // A resource counted in total_ with its bookkeeping, idle or on its way
+  // in or out. A null resource stands for a reserved or freed slot.
+  struct Entry {
+    UniquePtr resource;
+    Clock::time_point since{}; // returned at; kept once idle time is tracked
+    ResourceUsage usage{};
+
+    explicit operator bool() const noexcept { return resource != nullptr; }
+  };
+
+  // One idle list, oldest first; padded so neighbouring shard locks don't
+  // share a cache line
+  struct alignas(64) Shard {
+    std::mutex mtx;
+    std::vector<Entry> idle;
+  };
+
+  // Wakes the maintenance thread early on shutdown. Shared with the thread
+  // for the same reason as AsyncQueue.
+  struct MaintenanceTimer {
+    std::mutex mtx;
+    std::condition_variable cv;
+    bool stopped{false};
+  };
+
+  // A waiter and the idle resource (or, when null, the reserved slot) being
+  // handed to it; shared so a rejected post can give both back
+  struct Handoff {
+    AsyncWaiter waiter;
+    Entry entry;
+  };
+
+  friend class PooledRef<T>;
+
+  explicit ResourcePool(std::size_t max_size, Factory factory, Validator validator, std::size_t shards)
     : max_size_(max_size ? max_size : 1),
       factory_(std::move(factory)),
-      validator_(std::move(validator)) {}
+      validator_(std::move(validator)),
+      shards_(shards ? shards : 1) {
+    // Returning a resource must not grow a vector (and allocate); every
+    // resource may end up in the same shard
+    for (auto& shard : shards_) shard.idle.reserve(max_size_);
+  }
+
+  // Deleter of the owning std::shared_ptr: shut down, then free the pool once
+  // no PooledRef points into it
+  static void retire(ResourcePool* pool) {
+    pool->shutdown();
+    pool->unref();
+  }
+
+  void unref() noexcept {
+    if (refs_.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+      delete this;
+    }
+  }
+
+  Ref make_ref(Entry e) noexcept {
+    if (!e) return Ref{};
+    refs_.fetch_add(1, std::memory_order_relaxed);
+    return Ref(this, e.resource.release(), e.usage);
+  }
+
+  SharedPtr wrap_shared(UniquePtr u, const ResourceUsage& usage) {
+    if (!u) return nullptr;
+    // On allocation failure shared_ptr runs the deleter, returning the resource
+    return SharedPtr(u.release(), Deleter{this->weak_from_this(), usage});
+  }
+
+  SharedPtr wrap_shared(Entry e) {
+    return wrap_shared(std::move(e.resource), e.usage);
+  }
 
   struct Deleter {
     std::weak_ptr<ResourcePool> pool;
+    ResourceUsage usage; // updated in place by mark_failed()
     void operator()(T* p) const noexcept {
       if (!p) return;
       if (auto sp = pool.lock()) {
-        sp->release_raw(p);
+        sp->release_raw(p, usage);
       } else {
         // Pool no longer exists; just delete the resource
         delete p;
@@ -170,7 +579,7 @@ private:
     }
   };
 
-  // Eagerly create up to warmup_size resources and place them into idle_.
+  // Eagerly create up to warmup_size resources and place them into the shards.
   // Throws if factory fails or validator rejects any created resource; in that
   // case, no state is committed to the pool (strong exception safety).
   void perform_warmup(std::size_t warmup_size) {
@@ -184,218 +593,535 @@ private:
       if (!u) {
         throw std::runtime_error("ResourcePool warm-up: factory returned null");
       }
-      if (validator_) {
-        bool ok = false;
-        try {
-          ok = validator_(*u);
-        } catch (...) {
-          ok = false;
-        }
-        if (!ok) {
-          throw std::runtime_error("ResourcePool warm-up: validator rejected created resource");
-        }
+      if (!is_valid(*u)) {
+        throw std::runtime_error("ResourcePool warm-up: validator rejected created resource");
       }
       created.push_back(std::move(u));
     }
 
-    // Commit created resources to the pool atomically under the mutex
-    {
-      std::lock_guard<std::mutex> lk(mtx_);
-      for (auto& u : created) {
-        idle_.push_back(std::move(u));
-      }
-      total_ += target;
+    // Commit created resources to the pool, spread across the shards. The
+    // pool is not shared yet, so no waiter can be missed.
+    for (std::size_t i = 0; i < created.size(); ++i) {
+      auto& shard = shards_[i % shards_.size()];
+      std::lock_guard<std::mutex> lk(shard.mtx);
+      shard.idle.push_back(Entry{std::move(created[i])});
     }
-    cv_.notify_all();
+    total_.fetch_add(target);
+    idle_count_.fetch_add(target);
   }
 
-  SharedPtr make_shared_from_unique_unlocked(std::unique_ptr<T> u, std::unique_lock<std::mutex>& lk) {
-    T* raw = u.release();
-    // Create shared_ptr with custom deleter referencing this pool
-    auto self = this->shared_from_this();
-    // Unlock before returning in case caller does work immediately
-    auto ptr = SharedPtr(raw, Deleter{self});
-    lk.unlock();
-    return ptr;
+  // Validate a checked-out resource outside the mutex; exceptions count as invalid
+  bool is_valid(const T& resource) const noexcept {
+    if (!validator_) return true;
+    try {
+      return validator_(resource);
+    } catch (...) {
+      return false;
+    }
   }
 
-  SharedPtr make_shared_from_idle_locked(std::unique_lock<std::mutex>& lk) {
-    // Pre-condition: lk holds the mutex and idle_ is non-empty
-    // Iterate to skip any invalid idle resources without risking deep recursion
-    while (true) {
-      std::unique_ptr<T> u = std::move(idle_.back());
-      idle_.pop_back();
+  // Validate `e`, recording the run in its usage
+  bool validate(Entry& e) const noexcept {
+    if (!is_valid(*e.resource)) return false;
+    e.usage.validated = Clock::now();
+    e.usage.uses_since_validated = 0;
+    e.usage.failed = false;
+    return true;
+  }
 
-      if (!validator_) {
-        return make_shared_from_unique_unlocked(std::move(u), lk);
-      }
+  // Default ValidationPolicy: validate on every acquire and release
+  bool validate_always() const noexcept {
+    return validate_idle_after_.load(std::memory_order_relaxed) == 0 &&
+           validate_every_n_.load(std::memory_order_relaxed) == 0 &&
+           !validate_on_error_only_.load(std::memory_order_relaxed);
+  }
 
-      // Validate outside the mutex to avoid potential deadlocks and long holds
-      auto validator_copy = validator_;
-      T* raw = u.get();
-      lk.unlock();
-      bool ok = false;
-      try {
-        ok = validator_copy ? validator_copy(*raw) : true;
-      } catch (...) {
-        ok = false; // Treat validator exceptions as invalid resource
+  // Count a checkout of `e` and validate it if the policy says it is due;
+  // false if the validator rejected it
+  bool validate_for_checkout(Entry& e) const noexcept {
+    if (!validator_) return true;
+    ++e.usage.uses_since_validated;
+    bool due = validate_always();
+    if (!due && !validate_on_error_only_.load(std::memory_order_relaxed)) {
+      const std::chrono::milliseconds idle_after{validate_idle_after_.load(std::memory_order_relaxed)};
+      const std::uint32_t every_n = validate_every_n_.load(std::memory_order_relaxed);
+      due = (idle_after > std::chrono::milliseconds::zero() && Clock::now() - e.since > idle_after) ||
+            (every_n != 0 && e.usage.uses_since_validated >= every_n);
+    }
+    return !due || validate(e);
+  }
+
+  // A freshly created resource (validated by create_resource())
+  Entry make_entry(UniquePtr u) const {
+    const auto now = Clock::now();
+    return Entry{std::move(u), now, ResourceUsage{now}};
+  }
+
+  // Index of the calling thread's home shard. Threads are numbered on first
+  // use, so consecutive threads land on different shards.
+  std::size_t home_shard() const noexcept {
+    if (shards_.size() == 1) return 0;
+    static std::atomic<std::size_t> next_thread{0};
+    static thread_local const std::size_t thread_index = next_thread.fetch_add(1, std::memory_order_relaxed);
+    return thread_index % shards_.size();
+  }
+
+  // Park an idle resource in the caller's home shard
+  void push_idle(Entry&& e) noexcept {
+    auto& shard = shards_[home_shard()];
+    std::lock_guard<std::mutex> lk(shard.mtx);
+    shard.idle.push_back(std::move(e)); // capacity reserved up front
+    idle_count_.fetch_add(1);
+  }
+
+  // Pop an idle resource from the home shard, else steal from the others
+  Entry pop_idle() noexcept {
+    if (idle_count_.load() == 0) return {};
+    const std::size_t n = shards_.size();
+    const std::size_t home = home_shard();
+    for (std::size_t i = 0; i < n; ++i) {
+      auto& shard = shards_[(home + i) % n];
+      std::lock_guard<std::mutex> lk(shard.mtx);
+      if (!shard.idle.empty()) {
+        Entry e = std::move(shard.idle.back());
+        shard.idle.pop_back();
+        idle_count_.fetch_sub(1);
+        return e;
       }
-      lk.lock();
+    }
+    return {};
+  }
 
-      if (shutting_down_) {
-        // Pool is shutting down: discard resource
-        // Decrement total_ and destroy outside the lock
-        --total_;
-        std::unique_ptr<T> to_destroy = std::move(u);
-        lk.unlock();
-        to_destroy.reset();
-        cv_.notify_one();
-        return nullptr;
+  // Destroy every idle resource (after shutdown), outside the shard locks
+  void destroy_idle() noexcept {
+    while (Entry e = pop_idle()) {
+      total_.fetch_sub(1);
+    }
+  }
+
+  // Destroy idle resources parked before `cutoff`, oldest first, leaving at
+  // least `min_idle` idle across the pool
+  void evict_idle(Clock::time_point cutoff, std::size_t min_idle) {
+    std::vector<UniquePtr> evicted;
+    for (auto& shard : shards_) {
+      std::lock_guard<std::mutex> lk(shard.mtx);
+      // Scan the whole shard: entries handed back after a failed hand-off
+      // keep their old `since`, so the list is only roughly oldest-first
+      auto keep = shard.idle.begin();
+      for (auto it = shard.idle.begin(); it != shard.idle.end(); ++it) {
+        if (it->since < cutoff && idle_count_.load() > min_idle) {
+          evicted.push_back(std::move(it->resource));
+          idle_count_.fetch_sub(1);
+        } else {
+          if (keep != it) *keep = std::move(*it);
+          ++keep;
+        }
       }
+      shard.idle.erase(keep, shard.idle.end());
+    }
+    for (auto& u : evicted) {
+      u.reset();    // destroyed outside the shard locks
+      put_back({}); // its slot may go to a waiter
+    }
+  }
 
-      if (ok) {
-        return make_shared_from_unique_unlocked(std::move(u), lk);
+  // Validate idle resources one at a time, outside the locks, so the rest
+  // stay available. Valid ones go back where their idle time sorts them.
+  void validate_idle() {
+    const auto pass_start = Clock::now();
+    for (auto& shard : shards_) {
+      while (!shutting_down_.load()) {
+        Entry entry;
+        {
+          std::lock_guard<std::mutex> lk(shard.mtx);
+          auto it = std::find_if(shard.idle.begin(), shard.idle.end(),
+                                 [&](const Entry& e) { return e.usage.validated < pass_start; });
+          if (it == shard.idle.end()) break;
+          entry = std::move(*it);
+          shard.idle.erase(it);
+          idle_count_.fetch_sub(1);
+        }
+        if (!validate(entry)) {
+          entry.resource.reset();
+          put_back({});
+          continue;
+        }
+        if (shutting_down_.load() || has_waiters()) {
+          put_back(std::move(entry));
+          continue;
+        }
+        {
+          std::lock_guard<std::mutex> lk(shard.mtx);
+          auto pos = std::upper_bound(shard.idle.begin(), shard.idle.end(), entry.since,
+                                      [](Clock::time_point t, const Entry& e) { return t < e.since; });
+          shard.idle.insert(pos, std::move(entry)); // capacity reserved up front
+          idle_count_.fetch_add(1);
+        }
+        // Same hand-off checks as put_back()
+        if (shutting_down_.load()) {
+          destroy_idle();
+        } else if (has_waiters()) {
+          serve_waiters({});
+        }
       }
+    }
+  }
 
-      // Not ok: discard and adjust counters, then try next option
-      --total_;
-      std::unique_ptr<T> to_destroy = std::move(u);
+  // Runs run_maintenance() every `interval` until shutdown. Holds the pool
+  // only for the duration of a pass.
+  static void maintenance_loop(std::weak_ptr<ResourcePool> pool, std::shared_ptr<MaintenanceTimer> timer,
+                               std::chrono::milliseconds interval) {
+    std::unique_lock<std::mutex> lk(timer->mtx);
+    while (!timer->cv.wait_for(lk, interval, [&] { return timer->stopped; })) {
       lk.unlock();
-      to_destroy.reset();
-      cv_.notify_one();
+      if (auto sp = pool.lock()) {
+        try {
+          sp->run_maintenance();
+        } catch (...) {
+          // Keep maintaining; the next pass retries
+        }
+      }
       lk.lock();
+    }
+  }
 
-      if (!idle_.empty()) {
-        continue; // check next idle resource
-      }
-      if (total_ < max_size_) {
-        ++total_;
-        lk.unlock();
-        return make_shared_from_factory();
-      }
-      return nullptr; // nothing to return now
+  // Reserve a slot for a resource to be created; false if the pool is full
+  bool try_reserve() noexcept {
+    std::size_t n = total_.load();
+    while (n < max_size_) {
+      if (total_.compare_exchange_weak(n, n + 1)) return true;
     }
+    return false;
   }
 
-  SharedPtr make_shared_from_factory() {
+  // Whether a release must go through mtx_ to hand over or wake someone.
+  // Waiters announce themselves before re-checking idle_count_/total_, and
+  // releasers publish before calling this (all seq_cst), so one side always
+  // sees the other.
+  bool has_waiters() const noexcept {
+    return blocked_.load() != 0 || async_->queued.load() != 0;
+  }
+
+  // Create a resource in a slot already counted in total_; gives the slot
+  // back and throws if the factory fails or the validator rejects the result
+  UniquePtr create_resource() {
     UniquePtr u;
     try {
       u = factory_();
     } catch (...) {
       // Roll back the total_ count and rethrow
-      {
-        std::lock_guard<std::mutex> lk(mtx_);
-        --total_;
-      }
-      cv_.notify_one();
+      put_back({});
       throw;
     }
     if (!u) {
       // Factory returned null; roll back and throw
-      {
-        std::lock_guard<std::mutex> lk(mtx_);
-        --total_;
-      }
-      cv_.notify_one();
+      put_back({});
       throw std::runtime_error("ResourcePool factory returned null");
     }
-    if (validator_) {
-      bool ok = false;
-      try {
-        ok = validator_(*u);
-      } catch (...) {
-        ok = false; // Treat exception as invalid resource
-      }
-      if (!ok) {
-        // Created resource is invalid; destroy and roll back, then throw
-        u.reset();
-        {
-          std::lock_guard<std::mutex> lk(mtx_);
-          --total_;
-        }
-        cv_.notify_one();
-        throw std::runtime_error("ResourcePool validator rejected created resource");
-      }
+    if (!is_valid(*u)) {
+      // Created resource is invalid; destroy and roll back, then throw
+      u.reset();
+      put_back({});
+      throw std::runtime_error("ResourcePool validator rejected created resource");
     }
+    return u;
+  }
 
-    auto self = this->shared_from_this();
-    return SharedPtr(u.release(), Deleter{self});
+  // Take an idle resource (validated as the policy requires), or create one
+  // if a slot is free; empty if neither. A rejected idle resource is
+  // destroyed and its slot reused.
+  Entry checkout_now() {
+    if (shutting_down_.load()) return {};
+
+    bool have_slot = false;
+    while (Entry e = pop_idle()) {
+      if (have_slot) put_back({}); // slot of the previously rejected one
+      have_slot = false;
+      // Validate outside any lock to avoid potential deadlocks and long holds
+      if (validate_for_checkout(e)) {
+        if (!shutting_down_.load()) return e;
+        // Pool is shutting down: discard resource
+        e.resource.reset();
+        put_back({});
+        return {};
+      }
+      e.resource.reset();
+      have_slot = true;
+    }
+    if (have_slot || try_reserve()) {
+      // will create outside any lock
+      return make_entry(create_resource());
+    }
+    return {};
   }
 
   SharedPtr acquire_until(const Clock::time_point& deadline) {
+    return wrap_shared(checkout_until(deadline));
+  }
+
+  Entry checkout_until(const Clock::time_point& deadline) {
+    if (shutting_down_.load()) {
+      throw std::runtime_error("ResourcePool is shutting down");
+    }
+    if (Entry e = checkout_now()) {
+      return e;
+    }
+
+    // Slow path: wait on cv_ for a release
     std::unique_lock<std::mutex> lk(mtx_);
+    blocked_.fetch_add(1);
+    struct Unblock {
+      std::atomic<std::size_t>& blocked;
+      ~Unblock() { blocked.fetch_sub(1); }
+    } unblock{blocked_};
+    const auto ready = [&] { return shutting_down_.load() || idle_count_.load() != 0 || total_.load() < max_size_; };
 
     while (true) {
-      if (shutting_down_) {
+      if (shutting_down_.load()) {
         throw std::runtime_error("ResourcePool is shutting down");
       }
 
-      if (!idle_.empty()) {
-        // Note: make_shared_from_idle_locked may return nullptr in rare races
-        // (e.g., all idle are invalid and capacity is immediately consumed by
-        // another waiter while we're validating). For blocking acquire we must
-        // not propagate nullptr; instead, continue the loop to either wait or
-        // retry until timeout/shutdown.
-        auto sp = make_shared_from_idle_locked(lk);
-        if (sp) {
-          return sp;
+      if (ready()) {
+        // Note: checkout_now may return nullptr when another thread wins the
+        // race for the idle resource or free slot. For blocking acquire we
+        // must not propagate nullptr; instead, retry or wait until
+        // timeout/shutdown.
+        lk.unlock();
+        if (Entry e = checkout_now()) {
+          return e;
         }
-        // Ensure we hold the lock before next loop iteration
-        if (!lk.owns_lock()) lk.lock();
-        // Fall through to the loop head; conditions will be re-evaluated and
-        // we will wait if necessary according to the deadline.
+        lk.lock();
         continue;
       }
-      if (total_ < max_size_) {
-        ++total_;
-        lk.unlock();
-        return make_shared_from_factory();
-      }
 
       if (deadline == Clock::time_point::max()) {
-        cv_.wait(lk, [&]{ return shutting_down_ || !idle_.empty() || total_ < max_size_; });
-      } else {
-        if (cv_.wait_until(lk, deadline, [&]{ return shutting_down_ || !idle_.empty() || total_ < max_size_; })) {
-          continue; // condition satisfied; loop will handle
-        } else {
-          // timeout
-          return nullptr;
-        }
+        cv_.wait(lk, ready);
+      } else if (!cv_.wait_until(lk, deadline, ready)) {
+        // timeout
+        return {};
+      }
+    }
+  }
+
+  // Return raw pointer back to pool (called by the SharedPtr deleter and
+  // PooledRef). Validated unless the policy only checks failed resources.
+  void release_raw(T* p, ResourceUsage usage) noexcept {
+    Entry e{std::unique_ptr<T>(p), {}, usage};
+    // Validate outside the mutex to avoid deadlocks
+    if (validator_ && (usage.failed || validate_always()) && !validate(e)) {
+      // Discard invalid; its slot may go to a waiter
+      e.resource.reset();
+      put_back({});
+      return;
+    }
+    if (track_idle_time_.load(std::memory_order_relaxed)) {
+      e.since = Clock::now();
+    }
+    put_back(std::move(e));
+  }
+
+  // Return a resource counted in total_ to the pool. An empty `e` gives back
+  // a slot instead (total_ shrinks). Without waiters this only touches the
+  // home shard; otherwise serve_waiters() hands it over under mtx_.
+  void put_back(Entry&& e) noexcept {
+    if (!e) {
+      total_.fetch_sub(1);
+      if (!has_waiters()) return;
+    } else if (!shutting_down_.load() && !has_waiters()) {
+      push_idle(std::move(e));
+      if (shutting_down_.load()) {
+        // Raced with shutdown(), which may already have emptied the shards
+        destroy_idle();
+        return;
       }
+      if (!has_waiters()) return;
     }
+    serve_waiters(std::move(e));
+  }
+
+  // Hand `e` (or, when empty, idle resources and free slots) to the oldest
+  // async waiters, park what is left as idle and wake a blocked acquire()
+  void serve_waiters(Entry&& e) noexcept {
+    std::unique_lock<std::mutex> lk(mtx_);
+    while (!shutting_down_.load() && async_->queued.load() != 0) {
+      if (!e) e = pop_idle();
+      const bool reserved = !e && try_reserve();
+      if (!e && !reserved) break;
+      std::optional<AsyncWaiter> w = pop_async_waiter_locked();
+      if (!w) {
+        // Expired meanwhile
+        if (reserved) total_.fetch_sub(1);
+        break;
+      }
+      lk.unlock();
+      if (!try_dispatch(*w, e)) {
+        fail_waiter(std::move(*w), executor_rejected());
+        if (reserved) total_.fetch_sub(1);
+      }
+      lk.lock();
+    }
+    if (e && !shutting_down_.load()) {
+      push_idle(std::move(e));
+    } else if (e) {
+      // Drop resource, reduce total
+      total_.fetch_sub(1);
+    }
+    lk.unlock();
+    e.resource.reset(); // destroyed outside the lock
+    cv_.notify_one();
+  }
+
+  template <class Executor>
+  static Post make_post(Executor executor) {
+    return [executor = std::move(executor)](std::function<void()> task) mutable -> bool {
+      if constexpr (std::is_convertible_v<decltype(executor.post(std::move(task))), bool>) {
+        return executor.post(std::move(task));
+      } else {
+        executor.post(std::move(task));
+        return true;
+      }
+    };
+  }
+
+  static std::exception_ptr executor_rejected() {
+    return std::make_exception_ptr(std::runtime_error("ResourcePool: executor rejected async_acquire completion"));
   }
 
-  // Return raw pointer back to pool (called by SharedPtr deleter)
-  void release_raw(T* p) noexcept {
-    std::unique_ptr<T> u(p);
-    bool valid = true;
-    // Validate outside the mutex to avoid deadlocks; catch exceptions
-    auto validator_copy = validator_;
-    if (validator_copy) {
+  // Complete `w` with an error (or, for a null `error`, a timeout) on its
+  // executor, falling back to the current thread
+  static void fail_waiter(AsyncWaiter w, std::exception_ptr error) noexcept {
+    auto callback = std::make_shared<AcquireCallback>(std::move(w.callback));
+    bool posted = false;
+    try {
+      posted = w.post([callback, error] { (*callback)(nullptr, error); });
+    } catch (...) {
+    }
+    if (!posted) {
       try {
-        valid = validator_copy(*u);
+        (*callback)(nullptr, error);
       } catch (...) {
-        valid = false;
       }
     }
+  }
 
-    bool notify = false;
+  void enqueue_async(AsyncWaiter w) {
+    if (shutting_down_.load()) {
+      fail_waiter(std::move(w), std::make_exception_ptr(std::runtime_error("ResourcePool is shutting down")));
+      return;
+    }
+    Entry e = pop_idle();
+    if (e || try_reserve()) {
+      // An empty `e` is created on the executor
+      if (!try_dispatch(w, e)) {
+        fail_waiter(std::move(w), executor_rejected());
+        put_back(std::move(e));
+      }
+      return;
+    }
+
+    std::unique_lock<std::mutex> lk(mtx_);
+    if (shutting_down_.load()) {
+      lk.unlock();
+      fail_waiter(std::move(w), std::make_exception_ptr(std::runtime_error("ResourcePool is shutting down")));
+      return;
+    }
+    const bool bounded = w.deadline != Clock::time_point::max();
     {
-      std::lock_guard<std::mutex> lk(mtx_);
-      if (shutting_down_) {
-        // Drop resource, reduce total
-        --total_;
-        notify = true;
-      } else if (!valid) {
-        // Discard invalid; reduce total
-        --total_;
-        notify = true;
+      std::lock_guard<std::mutex> alk(async_->mtx);
+      async_->waiters.push_back(std::move(w));
+      async_->queued.fetch_add(1);
+    }
+    if (bounded) {
+      if (!expiry_thread_.joinable()) {
+        expiry_thread_ = std::thread(&ResourcePool::expiry_loop, async_);
       } else {
-        idle_.push_back(std::move(u));
-        notify = true;
+        async_->cv.notify_one();
+      }
+    }
+    lk.unlock();
+    // A release between the checks above and queueing may have missed us
+    if (idle_count_.load() != 0 || total_.load() < max_size_) {
+      serve_waiters({});
+    }
+  }
+
+  std::optional<AsyncWaiter> pop_async_waiter_locked() {
+    std::lock_guard<std::mutex> alk(async_->mtx);
+    if (async_->waiters.empty()) return std::nullopt;
+    AsyncWaiter w = std::move(async_->waiters.front());
+    async_->waiters.pop_front();
+    async_->queued.fetch_sub(1);
+    return w;
+  }
+
+  // Post the completion of `w` with `e` (empty => create a resource in the
+  // slot already reserved for it). On rejection both are left with the caller.
+  bool try_dispatch(AsyncWaiter& w, Entry& e) noexcept {
+    std::shared_ptr<Handoff> handoff;
+    try {
+      handoff = std::make_shared<Handoff>(Handoff{std::move(w), std::move(e)});
+      auto self = this->shared_from_this();
+      if (handoff->waiter.post([self, handoff] {
+            self->complete_async(std::move(handoff->waiter), std::move(handoff->entry));
+          })) {
+        return true;
+      }
+    } catch (...) {
+    }
+    if (handoff) {
+      w = std::move(handoff->waiter);
+      e = std::move(handoff->entry);
+    }
+    return false;
+  }
+
+  // Runs on the waiter's executor: validate the handed-over resource as the
+  // policy requires (if rejected, create a replacement in its slot) and call back
+  void complete_async(AsyncWaiter w, Entry e) {
+    if (e && !validate_for_checkout(e)) {
+      e.resource.reset();
+    }
+    SharedPtr resource;
+    std::exception_ptr error;
+    try {
+      resource = wrap_shared(e ? std::move(e) : make_entry(create_resource()));
+    } catch (...) {
+      error = std::current_exception();
+    }
+    try {
+      w.callback(std::move(resource), error);
+    } catch (...) {
+    }
+  }
+
+  // Completes queued async waiters whose deadline has passed
+  static void expiry_loop(std::shared_ptr<AsyncQueue> q) {
+    std::unique_lock<std::mutex> lk(q->mtx);
+    while (!q->stopped) {
+      auto next = Clock::time_point::max();
+      for (const auto& w : q->waiters) next = std::min(next, w.deadline);
+      if (next == Clock::time_point::max()) {
+        q->cv.wait(lk);
+      } else {
+        q->cv.wait_until(lk, next);
+      }
+      std::vector<AsyncWaiter> expired;
+      const auto now = Clock::now();
+      for (auto it = q->waiters.begin(); it != q->waiters.end();) {
+        if (it->deadline <= now) {
+          expired.push_back(std::move(*it));
+          it = q->waiters.erase(it);
+          q->queued.fetch_sub(1);
+        } else {
+          ++it;
+        }
+      }
+      if (!expired.empty()) {
+        lk.unlock();
+        for (auto& w : expired) fail_waiter(std::move(w), nullptr);
+        lk.lock();
       }
     }
-    if (notify) cv_.notify_one();
   }
 
 private:
@@ -403,11 +1129,31 @@ private:
   Factory factory_{};
   Validator validator_{}; // optional
 
-  mutable std::mutex mtx_;
+  // Guards waiting and hand-over to waiters; idle lists have their own locks.
+  // Lock order: mtx_, then a Shard::mtx.
+  std::mutex mtx_;
   std::condition_variable cv_;
-  std::vector<UniquePtr> idle_;
-  std::size_t total_{0};
-  bool shutting_down_{false};
+  std::vector<Shard> shards_;
+  std::atomic<std::size_t> idle_count_{0}; // across all shards
+  std::atomic<std::size_t> total_{0};      // idle + in use, <= max_size_
+  std::atomic<std::size_t> blocked_{0};    // acquire() callers waiting on cv_
+  std::atomic<bool> shutting_down_{false};
+
+  std::shared_ptr<AsyncQueue> async_ = std::make_shared<AsyncQueue>();
+  std::thread expiry_thread_; // started by the first queued waiter with a deadline
+
+  // The owning std::shared_ptr plus one per outstanding PooledRef
+  std::atomic<std::size_t> refs_{1};
+
+  std::optional<Maintenance> maintenance_; // guarded by mtx_
+  std::atomic<bool> track_idle_time_{false};
+
+  // ValidationPolicy, read on every checkout without a lock
+  std::atomic<std::chrono::milliseconds::rep> validate_idle_after_{0};
+  std::atomic<std::uint32_t> validate_every_n_{0};
+  std::atomic<bool> validate_on_error_only_{false};
+  std::shared_ptr<MaintenanceTimer> maintenance_timer_ = std::make_shared<MaintenanceTimer>();
+  std::thread maintenance_thread_;
 };
 
 } // namespace resource
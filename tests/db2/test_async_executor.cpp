@@ -0,0 +1,107 @@
+// Unit tests for db2::BasicAsyncExecutor (no DB2 runtime required: a stand-in
+// connection type is pooled instead of db2::Connection)
+
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <chrono>
+#include <future>
+#include <latch>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <tuple>
+#include <vector>
+
+#include "db2/async_executor.h"
+
+using namespace std::chrono_literals;
+
+namespace {
+
+struct FakeConnection {
+  std::vector<std::string> executed;
+
+  void execute(const std::string& sql, const std::vector<db2::Param>& params) {
+    executed.push_back(sql + "/" + std::to_string(params.size()));
+  }
+
+  template <class Tuple>
+  std::vector<Tuple> query_as(const std::string& sql, const std::vector<db2::Param>&) {
+    if (sql == "FAIL") throw std::runtime_error("query failed");
+    return {Tuple{42, sql}};
+  }
+};
+
+using Executor = db2::BasicAsyncExecutor<FakeConnection>;
+using Pool = Executor::Pool;
+
+std::shared_ptr<Pool> make_pool(std::size_t max_size) {
+  return Pool::create(max_size, [] { return std::make_unique<FakeConnection>(); });
+}
+
+} // namespace
+
+TEST(AsyncExecutor, DeliversValueOnWorkerThread) {
+  auto pool = make_pool(2);
+  Executor exec(pool, {.thread_count = 2, .max_queue = 16, .name = "db2-test"});
+
+  std::promise<std::pair<std::thread::id, int>> done;
+  ASSERT_TRUE(exec.post([](FakeConnection&) { return 7; },
+                        [&](db2::AsyncResult<int> r) { done.set_value({std::this_thread::get_id(), r.get()}); }));
+  auto [tid, value] = done.get_future().get();
+  EXPECT_EQ(value, 7);
+  EXPECT_NE(tid, std::this_thread::get_id());
+}
+
+TEST(AsyncExecutor, ReportsExceptionsThroughResult) {
+  auto pool = make_pool(1);
+  Executor exec(pool);
+
+  using Row = std::tuple<int, std::string>;
+  std::promise<db2::AsyncResult<std::vector<Row>>> ok, failed;
+  ASSERT_TRUE(exec.query_as<Row>("SELECT", {}, [&](auto r) { ok.set_value(std::move(r)); }));
+  ASSERT_TRUE(exec.query_as<Row>("FAIL", {}, [&](auto r) { failed.set_value(std::move(r)); }));
+
+  auto ok_result = ok.get_future().get();
+  ASSERT_TRUE(ok_result.ok());
+  EXPECT_EQ(ok_result.get(), (std::vector<Row>{Row{42, "SELECT"}}));
+
+  auto failed_result = failed.get_future().get();
+  EXPECT_FALSE(failed_result.ok());
+  EXPECT_THROW(failed_result.get(), std::runtime_error);
+}
+
+TEST(AsyncExecutor, ConnectionReturnedBeforeCompletion) {
+  auto pool = make_pool(1);
+  Executor exec(pool, {.thread_count = 1, .max_queue = 4, .name = "db2-test"});
+
+  std::promise<std::size_t> in_use;
+  ASSERT_TRUE(exec.execute("INSERT", {db2::Param{1}},
+                           [&](db2::AsyncResult<void> r) {
+                             r.get();
+                             in_use.set_value(pool->in_use());
+                           }));
+  EXPECT_EQ(in_use.get_future().get(), 0u);
+}
+
+TEST(AsyncExecutor, RejectsWhenQueueFullWithoutBlocking) {
+  auto pool = make_pool(1);
+  Executor exec(pool, {.thread_count = 1, .max_queue = 1, .name = "db2-test"});
+
+  std::latch release(1);
+  std::atomic<int> completed{0};
+  auto on_done = [&](db2::AsyncResult<void>) { completed.fetch_add(1); };
+  // Occupy the only worker, then fill the single queue slot
+  ASSERT_TRUE(exec.post([&](FakeConnection&) { release.wait(); }, on_done));
+  while (exec.active() == 0) std::this_thread::sleep_for(1ms);
+  ASSERT_TRUE(exec.post([](FakeConnection&) {}, on_done));
+
+  const auto start = std::chrono::steady_clock::now();
+  EXPECT_FALSE(exec.post([](FakeConnection&) {}, on_done));
+  EXPECT_LT(std::chrono::steady_clock::now() - start, 100ms);
+
+  release.count_down();
+  while (completed.load() < 2) std::this_thread::sleep_for(1ms);
+  EXPECT_EQ(completed.load(), 2);
+}
@@ -0,0 +1,353 @@
+// db2::Connection tests against the in-process fake CLI (tests/fake_db2cli).
+// Built only with -DDB2_USE_FAKE_CLI=ON; no DB2 server or driver required.
+
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+#include "db2/db2.hpp"
+#include "fake_db2cli.h"
+
+using namespace std::chrono_literals;
+using fake_db2cli::Column;
+using fake_db2cli::Value;
+
+namespace {
+
+fake_db2cli::ResultSet items(int rows) {
+  fake_db2cli::ResultSet rs;
+  rs.columns = {Column{"ID", SQL_INTEGER, 10, 0, false}, Column{"NAME", SQL_VARCHAR, 40},
+                Column{"PRICE", SQL_DECIMAL, 10, 2}};
+  for (int i = 0; i < rows; ++i) {
+    rs.rows.push_back({int64_t{i}, i % 7 == 0 ? Value{nullptr} : Value{"n" + std::to_string(i)},
+                       std::to_string(i) + ".25"});
+  }
+  return rs;
+}
+
+int32_t first_column(const db2::Connection::Row& row) { return row.getInt32(1).value_or(-1); }
+
+struct FakeCliTest : ::testing::Test {
+  void SetUp() override {
+    fake_db2cli::reset();
+    conn.connect_with_conn_str("FAKE");
+  }
+  db2::Connection conn;
+};
+
+} // namespace
+
+TEST_F(FakeCliTest, StatementCacheReusesPreparedStatements) {
+  fake_db2cli::set_handler([](std::string_view, const std::vector<Value>& params) {
+    auto rs = items(0);
+    if (!params.empty()) rs.rows.push_back({params[0], std::string("x"), std::string("1.00")});
+    return rs;
+  });
+  conn.set_statement_cache_capacity(1);
+  for (int32_t id = 0; id < 3; ++id) {
+    auto rows = conn.query<int32_t>("SELECT ID FROM T WHERE ID = ?", {db2::Param{id}}, first_column);
+    ASSERT_EQ(rows, std::vector<int32_t>{id});
+  }
+  auto stats = conn.statement_cache_stats();
+  EXPECT_EQ(stats.misses, 1u);
+  EXPECT_EQ(stats.hits, 2u);
+  EXPECT_EQ(fake_db2cli::stats().prepares, 1u);
+
+  conn.execute("DELETE FROM T WHERE ID = ?", {db2::Param{1}});
+  EXPECT_EQ(conn.statement_cache_stats().evictions, 1u);
+  EXPECT_EQ(fake_db2cli::stats().live_statements, 1u);
+  conn.disconnect();
+  EXPECT_EQ(fake_db2cli::stats().live_statements, 0u);
+}
+
+TEST_F(FakeCliTest, BlockFetchMatchesRowAtATime) {
+  fake_db2cli::set_result("SELECT * FROM T", items(1000));
+  using Item = std::tuple<int32_t, std::optional<std::string>, double>;
+
+  auto single = conn.query_as<Item>("SELECT * FROM T");
+  const auto fetches = fake_db2cli::stats().fetches;
+  auto block = conn.query_as<Item>("SELECT * FROM T", {}, {.rowset_size = 128});
+  EXPECT_EQ(fetches, 1001u);
+  EXPECT_EQ(fake_db2cli::stats().fetches - fetches, 9u);
+
+  ASSERT_EQ(single.size(), 1000u);
+  EXPECT_EQ(single, block);
+  EXPECT_EQ(block[7], Item(7, std::nullopt, 7.25));
+  EXPECT_EQ(block[8], Item(8, "n8", 8.25));
+}
+
+TEST_F(FakeCliTest, BatchSendsEveryParameterSet) {
+  std::vector<std::vector<Value>> seen;
+  fake_db2cli::set_handler([&](std::string_view, const std::vector<Value>& params) {
+    seen.push_back(params);
+    fake_db2cli::ResultSet rs;
+    rs.rows_affected = 1;
+    return rs;
+  });
+  std::vector<std::vector<db2::Param>> rows;
+  for (int i = 0; i < 25; ++i) {
+    rows.push_back({db2::Param{std::string(i, 'a')}, db2::Param{i},
+                    i % 3 ? db2::Param{int64_t{1} << 40} : db2::Param{nullptr}});
+  }
+  auto result = conn.execute_batch("INSERT INTO T VALUES (?, ?, ?)", rows, {.chunk_size = 10});
+  EXPECT_TRUE(result.ok());
+  EXPECT_EQ(result.rows_processed, 25u);
+  EXPECT_EQ(result.rows_affected, 25);
+  EXPECT_EQ(fake_db2cli::stats().executes, 3u);
+  ASSERT_EQ(seen.size(), 25u);
+  EXPECT_EQ(std::get<std::string>(seen[7][0]), std::string(7, 'a'));
+  EXPECT_EQ(std::get<int64_t>(seen[7][1]), 7);
+  EXPECT_TRUE(std::holds_alternative<std::nullptr_t>(seen[9][2]));
+  EXPECT_EQ(std::get<int64_t>(seen[10][2]), int64_t{1} << 40);
+}
+
+TEST_F(FakeCliTest, InjectedFailureCarriesSqlstate) {
+  fake_db2cli::inject_failure("UPDATE", "40001", -911);
+  try {
+    conn.execute("UPDATE T SET A = ?", {db2::Param{1}});
+    FAIL() << "expected db2::Error";
+  } catch (const db2::Error& e) {
+    EXPECT_EQ(e.sqlstate(), "40001");
+    EXPECT_EQ(e.native_error(), -911);
+  }
+  // Only the next matching call fails
+  EXPECT_NO_THROW(conn.execute("UPDATE T SET A = ?", {db2::Param{1}}));
+  EXPECT_EQ(fake_db2cli::stats().connects, 1u);
+}
+
+TEST_F(FakeCliTest, DroppedLinkReconnectsOutsideTransactions) {
+  fake_db2cli::set_result("SELECT * FROM T", items(3));
+  fake_db2cli::drop_connections();
+  EXPECT_EQ(conn.query<int32_t>("SELECT * FROM T", first_column).size(), 3u);
+  EXPECT_EQ(fake_db2cli::stats().connects, 2u);
+
+  // Inside a transaction the work is lost, so the failure surfaces instead
+  conn.begin();
+  fake_db2cli::drop_connections();
+  EXPECT_THROW(conn.execute("INSERT INTO T VALUES (1)"), db2::Error);
+  EXPECT_EQ(fake_db2cli::stats().connects, 2u);
+  EXPECT_FALSE(conn.rollback());
+  EXPECT_NO_THROW(conn.execute("INSERT INTO T VALUES (1)"));
+}
+
+TEST_F(FakeCliTest, TimeoutAndCancelLeaveConnectionUsable) {
+  fake_db2cli::set_result("SELECT * FROM T", items(3));
+  fake_db2cli::set_latency({.execute = 2500ms});
+  auto start = std::chrono::steady_clock::now();
+  EXPECT_THROW(conn.query<int32_t>("SELECT * FROM T", {.timeout = 200ms}, first_column), db2::Error);
+  EXPECT_LT(std::chrono::steady_clock::now() - start, 2000ms);
+
+  std::thread canceller([&] {
+    std::this_thread::sleep_for(100ms);
+    EXPECT_TRUE(conn.cancel());
+  });
+  start = std::chrono::steady_clock::now();
+  try {
+    conn.execute("UPDATE T SET A = 1");
+    ADD_FAILURE() << "expected cancellation";
+  } catch (const db2::Error& e) {
+    EXPECT_EQ(e.sqlstate(), "HY008");
+  }
+  EXPECT_LT(std::chrono::steady_clock::now() - start, 1000ms);
+  canceller.join();
+
+  fake_db2cli::set_latency({});
+  EXPECT_EQ(conn.query<int32_t>("SELECT * FROM T", first_column).size(), 3u);
+  EXPECT_EQ(fake_db2cli::stats().connects, 1u);
+}
+
+TEST_F(FakeCliTest, OpenBreakerFailsFastWithoutConnecting) {
+  conn.set_circuit_breaker(std::make_shared<db2::CircuitBreaker>(
+      db2::CircuitBreaker::Options{.initial_backoff = 100ms, .max_backoff = 100ms}));
+  fake_db2cli::fail_connects(100);
+  fake_db2cli::drop_connections();
+  EXPECT_THROW(conn.execute("UPDATE T SET A = 1"), std::runtime_error);
+  EXPECT_EQ(conn.circuit_breaker()->state(), db2::CircuitBreaker::State::Open);
+
+  const auto attempts = fake_db2cli::stats().connect_failures;
+  EXPECT_THROW(conn.execute("UPDATE T SET A = 1"), std::runtime_error);
+  EXPECT_EQ(fake_db2cli::stats().connect_failures, attempts);
+
+  fake_db2cli::fail_connects(0);
+  std::this_thread::sleep_for(150ms);
+  EXPECT_NO_THROW(conn.execute("UPDATE T SET A = 1"));
+  EXPECT_EQ(conn.circuit_breaker()->state(), db2::CircuitBreaker::State::Closed);
+}
+
+TEST_F(FakeCliTest, ReadLobStreamsInChunks) {
+  std::string clob(200 * 1024 + 17, 'c');
+  for (std::size_t i = 0; i < clob.size(); i += 1000) clob[i] = static_cast<char>('a' + i % 26);
+  const std::string blob("\x00\x01\xFF\x00binary", 10);
+  fake_db2cli::ResultSet rs;
+  rs.columns = {Column{"DOC", SQL_CLOB, 1 << 30}, Column{"RAW", SQL_BLOB, 1 << 20}};
+  rs.rows = {{clob, blob}, {nullptr, std::string()}, {clob, blob}};
+  fake_db2cli::set_result("SELECT DOC, RAW FROM T", rs);
+
+  auto cursor = conn.open_cursor("SELECT DOC, RAW FROM T");
+  const auto* row = cursor.next();
+  ASSERT_NE(row, nullptr);
+  std::string streamed;
+  std::vector<std::size_t> sizes;
+  const auto calls = fake_db2cli::stats().get_data;
+  auto total = row->readLob(1, [&](std::string_view chunk) {
+    streamed.append(chunk);
+    sizes.push_back(chunk.size());
+    return true;
+  });
+  EXPECT_EQ(total, clob.size());
+  EXPECT_EQ(streamed, clob);
+  EXPECT_EQ(sizes, (std::vector<std::size_t>{65536, 65536, 65536, 8209}));
+  EXPECT_EQ(fake_db2cli::stats().get_data - calls, 4u);
+
+  std::string bytes;
+  EXPECT_EQ(row->readLob(2, [&](std::string_view chunk) { bytes.append(chunk); return true; }, 3), blob.size());
+  EXPECT_EQ(bytes, blob);
+
+  // NULL, and an empty value that produces no chunks
+  row = cursor.next();
+  ASSERT_NE(row, nullptr);
+  int chunks = 0;
+  auto count = [&](std::string_view) { ++chunks; return true; };
+  EXPECT_EQ(row->readLob(1, count), std::nullopt);
+  EXPECT_EQ(row->readLob(2, count), 0u);
+  EXPECT_EQ(chunks, 0);
+
+  // Stopping early leaves the cursor usable
+  row = cursor.next();
+  ASSERT_NE(row, nullptr);
+  EXPECT_EQ(row->readLob(1, [](std::string_view) { return false; }, 1000), 1000u);
+  EXPECT_EQ(cursor.next(), nullptr);
+  EXPECT_THROW(conn.query<int>("SELECT DOC, RAW FROM T", [](const db2::Connection::Row& r) {
+    return static_cast<int>(r.readLob(1, [](std::string_view) { return true; }, 0).value_or(0));
+  }), std::invalid_argument);
+}
+
+TEST_F(FakeCliTest, InstrumentationSeesEveryPhase) {
+  struct Recorder : db2::Instrumentation {
+    std::vector<Phase> phases;
+    std::uint64_t rows = 0;
+    std::vector<std::string> errors;
+    int reconnects = 0;
+    void on_phase(std::string_view, Phase phase, std::chrono::nanoseconds, std::uint64_t n) noexcept override {
+      phases.push_back(phase);
+      rows += n;
+    }
+    void on_error(std::string_view, std::string_view sqlstate) noexcept override { errors.emplace_back(sqlstate); }
+    void on_reconnect(bool ok) noexcept override { reconnects += ok; }
+  };
+  using Phase = db2::Instrumentation::Phase;
+  auto recorder = std::make_shared<Recorder>();
+  conn.set_instrumentation(recorder);
+  fake_db2cli::set_handler([](std::string_view, const std::vector<Value>&) { return items(5); });
+
+  conn.query<int32_t>("SELECT * FROM T WHERE ID > ?", {db2::Param{0}}, {.rowset_size = 2}, first_column);
+  EXPECT_EQ(recorder->phases, (std::vector<Phase>{Phase::Prepare, Phase::Execute, Phase::Fetch}));
+  EXPECT_EQ(recorder->rows, 5u);
+
+  fake_db2cli::inject_failure("BAD", "42704", -204);
+  EXPECT_THROW(conn.execute("BAD"), db2::Error);
+  fake_db2cli::drop_connections();
+  conn.execute("GOOD");
+  EXPECT_EQ(recorder->errors, (std::vector<std::string>{"42704", "08S01"}));
+  EXPECT_EQ(recorder->reconnects, 1);
+}
+
+TEST_F(FakeCliTest, IntegerGetterTruncatesDecimalWithAnyRowsetSize) {
+  fake_db2cli::ResultSet rs;
+  rs.columns = {Column{"PRICE", SQL_DECIMAL, 10, 2}};
+  rs.rows = {{std::string("42.50")}, {std::string("-7.75")}, {std::string("3.00")}};
+  fake_db2cli::set_result("SELECT PRICE FROM T", rs);
+  const auto read = [](const db2::Connection::Row& row) { return *row.getInt64(1); };
+
+  for (std::size_t rowset_size : {1u, 2u}) {
+    SCOPED_TRACE(rowset_size);
+    auto rows = conn.query<int64_t>("SELECT PRICE FROM T", {}, {.rowset_size = rowset_size}, read);
+    EXPECT_EQ(rows, (std::vector<int64_t>{42, -7, 3}));
+  }
+}
+
+TEST_F(FakeCliTest, StringParamsBindWithExplicitLengths) {
+  std::vector<Value> seen;
+  fake_db2cli::set_handler([&seen](std::string_view, const std::vector<Value>& params) {
+    if (!params.empty()) seen = params;
+    return fake_db2cli::ResultSet{};
+  });
+  constexpr const char* kInsert = "INSERT INTO T (A, B) VALUES (?, ?)";
+
+  // A view into a larger buffer with no NUL after it, and an empty string
+  const char buffer[] = {'a', 'b', 'c', 'd', 'e', 'f'};
+  conn.execute(kInsert, {db2::Param{std::string_view(buffer, 3)}, db2::Param{std::string()}});
+  ASSERT_EQ(seen.size(), 2u);
+  EXPECT_EQ(seen[0], Value{std::string("abc")});
+  EXPECT_EQ(seen[1], Value{std::string()});
+
+  // The cached statement is rebound with the longer value's size
+  const std::string longer(5000, 'x');
+  conn.execute(kInsert, {db2::Param{std::string_view(buffer, 1)}, db2::Param{longer}});
+  EXPECT_EQ(conn.statement_cache_stats().hits, 1u);
+  EXPECT_EQ(seen[0], Value{std::string("a")});
+  EXPECT_EQ(seen[1], Value{longer});
+}
+
+TEST_F(FakeCliTest, TransactionScopeFinishesOnce) {
+  {
+    db2::Connection::Transaction tx(conn);
+    tx.commit();
+    EXPECT_FALSE(tx.active());
+    EXPECT_THROW(tx.commit(), std::logic_error);
+    EXPECT_FALSE(tx.rollback());
+  }
+  {
+    db2::Connection::Transaction tx(conn);
+    EXPECT_TRUE(tx.rollback());
+    EXPECT_FALSE(tx.rollback());
+    EXPECT_THROW(tx.commit(), std::logic_error);
+  }
+  EXPECT_EQ(fake_db2cli::stats().commits, 1u);
+  EXPECT_EQ(fake_db2cli::stats().rollbacks, 1u);
+}
+
+TEST_F(FakeCliTest, BatchReconnectsAfterDroppedLink) {
+  std::vector<std::vector<db2::Param>> rows;
+  for (int i = 0; i < 4; ++i) rows.push_back({db2::Param{i}});
+  ASSERT_TRUE(conn.execute_batch("UPDATE T SET A = ?", rows).ok());
+
+  // The cached statement is freed by the reconnect; the retry must not touch it
+  fake_db2cli::drop_connections();
+  auto result = conn.execute_batch("UPDATE T SET A = ?", rows);
+  EXPECT_TRUE(result.ok());
+  EXPECT_EQ(result.rows_processed, 4u);
+  EXPECT_EQ(fake_db2cli::stats().connects, 2u);
+  EXPECT_EQ(fake_db2cli::stats().paramsets, 8u);
+  EXPECT_EQ(fake_db2cli::stats().invalid_handles, 0u);
+  EXPECT_EQ(fake_db2cli::stats().live_statements, 1u);
+}
+
+TEST_F(FakeCliTest, CancelDuringReconnectFindsNoStatement) {
+  conn.execute("UPDATE T SET A = ?", {db2::Param{1}});
+  fake_db2cli::set_latency({.connect = 300ms});
+  fake_db2cli::drop_connections();
+
+  // The cached statement fails on the dead link and is freed by the
+  // reconnect, which is still connecting when cancel() runs
+  std::thread canceller([&] {
+    std::this_thread::sleep_for(100ms);
+    EXPECT_FALSE(conn.cancel());
+  });
+  EXPECT_NO_THROW(conn.execute("UPDATE T SET A = ?", {db2::Param{2}}));
+  canceller.join();
+  EXPECT_EQ(fake_db2cli::stats().connects, 2u);
+  EXPECT_EQ(fake_db2cli::stats().cancels, 0u);
+  EXPECT_EQ(fake_db2cli::stats().invalid_handles, 0u);
+}
@@ -1,5 +1,7 @@
 #include <gtest/gtest.h>
 #include "db2/db2.hpp"
+#include <atomic>
+#include <chrono>
 #include <cstdlib>
 #include <thread>
 #include <future>
@@ -70,3 +72,313 @@ TEST(Db2Wrapper, ConcurrentAccess) {
   t1.join();
   t2.join();
 }
+
+TEST(Db2Wrapper, PreparedStatementCacheReuse) {
+  if (!has_conn_str()) GTEST_SKIP() << "DB2_CONN_STR not set";
+  db2::Connection c;
+  c.connect_with_conn_str(conn_str());
+  c.set_statement_cache_capacity(1);
+
+  const std::vector<db2::Param> params{db2::Param{int32_t{7}}};
+  for (int i = 0; i < 3; ++i) {
+    auto rows = c.query<int32_t>(
+        "SELECT CAST(? AS INTEGER) FROM SYSIBM.SYSDUMMY1", params,
+        [](const db2::Connection::Row& r){ return r.getInt32(1).value_or(0); });
+    ASSERT_EQ(rows.size(), 1u);
+    EXPECT_EQ(rows[0], 7);
+  }
+  auto stats = c.statement_cache_stats();
+  EXPECT_EQ(stats.misses, 1u);
+  EXPECT_EQ(stats.hits, 2u);
+  EXPECT_EQ(stats.size, 1u);
+
+  // A different SQL text evicts the least recently used statement
+  c.execute("VALUES CAST(? AS INTEGER)", params);
+  stats = c.statement_cache_stats();
+  EXPECT_EQ(stats.evictions, 1u);
+  EXPECT_EQ(stats.size, 1u);
+
+  // Reconnect/disconnect invalidates cached statements
+  c.disconnect();
+  EXPECT_EQ(c.statement_cache_stats().size, 0u);
+}
+
+TEST(Db2Wrapper, BlockFetchMatchesRowAtATime) {
+  if (!has_conn_str()) GTEST_SKIP() << "DB2_CONN_STR not set";
+  db2::Connection c;
+  c.connect_with_conn_str(conn_str());
+
+  const char* sql = "SELECT TABSCHEMA, TABNAME, COLCOUNT FROM SYSCAT.TABLES ORDER BY TABSCHEMA, TABNAME FETCH FIRST 100 ROWS ONLY";
+  using RowT = std::tuple<std::string, std::string, int32_t>;
+  auto mapper = [](const db2::Connection::Row& r) {
+    return RowT{r.getString(1).value_or(""), r.getString(2).value_or(""), r.getInt32(3).value_or(-1)};
+  };
+  auto single = c.query<RowT>(sql, mapper);
+  auto block = c.query<RowT>(sql, db2::QueryOptions{.rowset_size = 16}, mapper);
+  EXPECT_EQ(single, block);
+}
+
+TEST(Db2Wrapper, ExecuteBatchInChunks) {
+  if (!has_conn_str()) GTEST_SKIP() << "DB2_CONN_STR not set";
+  db2::Connection c;
+  c.connect_with_conn_str(conn_str());
+  c.execute("DECLARE GLOBAL TEMPORARY TABLE SESSION.BATCH_ITEMS (ID VARCHAR(36), NAME VARCHAR(100), "
+            "PRICE DOUBLE, QUANTITY INTEGER) ON COMMIT PRESERVE ROWS NOT LOGGED WITH REPLACE");
+
+  std::vector<std::vector<db2::Param>> rows;
+  for (int i = 0; i < 250; ++i) {
+    rows.push_back({db2::Param{"item-" + std::to_string(i)},
+                    i % 10 ? db2::Param{"name " + std::to_string(i)} : db2::Param{nullptr},
+                    db2::Param{i * 1.25}, db2::Param{int32_t{i}}});
+  }
+  auto res = c.execute_batch("INSERT INTO SESSION.BATCH_ITEMS VALUES (?, ?, ?, ?)", rows,
+                             db2::BatchOptions{.chunk_size = 100});
+  EXPECT_TRUE(res.ok()) << res.error_message;
+  EXPECT_EQ(res.rows_processed, rows.size());
+  EXPECT_EQ(res.rows_affected, static_cast<std::int64_t>(rows.size()));
+
+  auto counts = c.query<int32_t>("SELECT COUNT(*) FROM SESSION.BATCH_ITEMS WHERE NAME IS NULL",
+                                 [](const db2::Connection::Row& r) { return r.getInt32(1).value_or(-1); });
+  ASSERT_EQ(counts.size(), 1u);
+  EXPECT_EQ(counts[0], 25);
+}
+
+TEST(Db2Wrapper, ConnectionsShareEnvironment) {
+  if (!has_conn_str()) GTEST_SKIP() << "DB2_CONN_STR not set";
+  db2::Connection a;
+  db2::Connection b;
+  ASSERT_TRUE(a.environment());
+  EXPECT_EQ(a.environment(), b.environment());
+  a.connect_with_conn_str(conn_str());
+  b.connect_with_conn_str(conn_str());
+  EXPECT_NO_THROW(a.execute("VALUES 1"));
+  EXPECT_NO_THROW(b.execute("VALUES 1"));
+}
+
+TEST(Db2Wrapper, CursorStreamsRows) {
+  if (!has_conn_str()) GTEST_SKIP() << "DB2_CONN_STR not set";
+  db2::Connection c;
+  c.connect_with_conn_str(conn_str());
+
+  const char* sql = "SELECT TABNAME FROM SYSCAT.TABLES ORDER BY TABSCHEMA, TABNAME FETCH FIRST 50 ROWS ONLY";
+  auto expected = c.query<std::string>(sql, [](const db2::Connection::Row& r) { return r.getString(1).value_or(""); });
+
+  for (std::size_t rowset : {1u, 8u}) {
+    std::vector<std::string> streamed;
+    auto cursor = c.open_cursor(sql, {}, db2::QueryOptions{.rowset_size = rowset});
+    for (const auto& row : cursor) streamed.push_back(row.getString(1).value_or(""));
+    EXPECT_EQ(streamed, expected);
+    EXPECT_FALSE(cursor.is_open());
+  }
+
+  // Closing early releases the connection for the next call
+  auto cursor = c.open_cursor(sql);
+  ASSERT_NE(cursor.next(), nullptr);
+  cursor.close();
+  EXPECT_NO_THROW(c.execute("VALUES 1"));
+}
+
+TEST(Db2Wrapper, StringViewAccessors) {
+  if (!has_conn_str()) GTEST_SKIP() << "DB2_CONN_STR not set";
+  db2::Connection c;
+  c.connect_with_conn_str(conn_str());
+
+  const std::string long_text(3000, 'x');
+  const std::string sql = "SELECT CAST('" + long_text + "' AS VARCHAR(4000)), 'abc', "
+                          "CAST(NULL AS VARCHAR(10)), CAST(X'01AB' AS VARBINARY(8)) FROM SYSIBM.SYSDUMMY1";
+  for (std::size_t rowset : {1u, 4u}) {
+    auto cursor = c.open_cursor(sql, {}, db2::QueryOptions{.rowset_size = rowset});
+    const auto* row = cursor.next();
+    ASSERT_NE(row, nullptr);
+    std::string into = "previous contents";
+    EXPECT_TRUE(row->getStringInto(1, into));
+    EXPECT_EQ(into, long_text);
+    EXPECT_EQ(row->getStringView(2).value_or(""), "abc");
+    EXPECT_FALSE(row->getStringView(3).has_value());
+    EXPECT_EQ(row->getBytes(4).value_or(""), std::string_view("\x01\xAB", 2));
+  }
+}
+
+TEST(Db2Wrapper, QueryAsTuple) {
+  if (!has_conn_str()) GTEST_SKIP() << "DB2_CONN_STR not set";
+  db2::Connection c;
+  c.connect_with_conn_str(conn_str());
+
+  using RowT = std::tuple<int32_t, std::string, std::optional<double>, int64_t>;
+  const char* sql = "SELECT 7, 'seven', CAST(NULL AS DECIMAL(10,2)), CAST(123456789012 AS DECIMAL(15,0)) "
+                    "FROM SYSIBM.SYSDUMMY1 UNION ALL "
+                    "SELECT 8, 'eight', CAST(8.25 AS DECIMAL(10,2)), CAST(42 AS DECIMAL(15,0)) "
+                    "FROM SYSIBM.SYSDUMMY1 ORDER BY 1";
+  for (std::size_t rowset : {1u, 16u}) {
+    auto rows = c.query_as<RowT>(sql, {}, db2::QueryOptions{.rowset_size = rowset});
+    ASSERT_EQ(rows.size(), 2u);
+    EXPECT_EQ(rows[0], RowT(7, "seven", std::nullopt, 123456789012LL));
+    EXPECT_EQ(rows[1], RowT(8, "eight", 8.25, 42));
+  }
+  EXPECT_THROW((c.query_as<std::tuple<int32_t, std::string, double>>(sql)), std::runtime_error);
+}
+
+TEST(Db2Wrapper, CancelFromAnotherThread) {
+  if (!has_conn_str()) GTEST_SKIP() << "DB2_CONN_STR not set";
+  db2::Connection c;
+  c.connect_with_conn_str(conn_str());
+  EXPECT_FALSE(c.cancel()); // nothing running
+
+  // Deliberately expensive cross join
+  const char* slow = "SELECT COUNT(*) FROM SYSCAT.COLUMNS A, SYSCAT.COLUMNS B, SYSCAT.COLUMNS C";
+  std::atomic<bool> cancelled{false};
+  std::thread canceller([&] {
+    for (int i = 0; i < 200 && !cancelled; ++i) {
+      std::this_thread::sleep_for(std::chrono::milliseconds(50));
+      cancelled = c.cancel();
+    }
+  });
+  EXPECT_THROW(c.query<int32_t>(slow, [](const db2::Connection::Row& r) { return r.getInt32(1).value_or(0); }),
+               std::runtime_error);
+  canceller.join();
+  EXPECT_TRUE(cancelled.load());
+
+  // The connection stays usable, also with a timeout that does not expire
+  EXPECT_NO_THROW(c.execute("VALUES 1", {}, db2::QueryOptions{.timeout = std::chrono::seconds(30)}));
+}
+
+TEST(Db2Wrapper, TransactionCommitAndRollback) {
+  if (!has_conn_str()) GTEST_SKIP() << "DB2_CONN_STR not set";
+  db2::Connection c;
+  c.connect_with_conn_str(conn_str());
+  c.execute("DECLARE GLOBAL TEMPORARY TABLE SESSION.TXN_ITEMS (ID INTEGER) "
+            "ON COMMIT PRESERVE ROWS LOGGED WITH REPLACE");
+  auto count = [&] {
+    return c.query<int32_t>("SELECT COUNT(*) FROM SESSION.TXN_ITEMS",
+                            [](const db2::Connection::Row& r) { return r.getInt32(1).value_or(-1); })
+        .at(0);
+  };
+
+  {
+    db2::Connection::Transaction tx(c);
+    EXPECT_TRUE(c.in_transaction());
+    c.execute("INSERT INTO SESSION.TXN_ITEMS VALUES (?)", {db2::Param{1}});
+    c.execute("INSERT INTO SESSION.TXN_ITEMS VALUES (?)", {db2::Param{2}});
+    tx.commit();
+  }
+  EXPECT_FALSE(c.in_transaction());
+  EXPECT_EQ(count(), 2);
+
+  {
+    db2::Connection::Transaction tx(c);
+    c.execute("INSERT INTO SESSION.TXN_ITEMS VALUES (?)", {db2::Param{3}});
+    EXPECT_EQ(count(), 3); // visible inside the unit of work
+  } // rolled back
+  EXPECT_EQ(count(), 2);
+}
+
+TEST(Db2Wrapper, ColumnLookupByName) {
+  if (!has_conn_str()) GTEST_SKIP() << "DB2_CONN_STR not set";
+  db2::Connection c;
+  c.connect_with_conn_str(conn_str());
+
+  const char* sql = "SELECT 42 AS ORDER_ID, 'widget' AS ITEM FROM SYSIBM.SYSDUMMY1";
+  auto desc = c.describe(sql);
+  ASSERT_EQ(desc->size(), 2u);
+  EXPECT_EQ(desc->column(1).name, "ORDER_ID");
+  EXPECT_EQ(desc->index_of("ITEM"), 2);
+  EXPECT_EQ(c.describe(sql), desc); // cached per SQL text
+
+  for (std::size_t rowset : {1u, 16u}) {
+    auto items = c.query<std::string>(sql, db2::QueryOptions{.rowset_size = rowset}, [](const db2::Connection::Row& r) {
+      return r.getString(r.col("ITEM")).value_or("") + "#" + std::to_string(r.getInt32(r.col("ORDER_ID")).value_or(0));
+    });
+    ASSERT_EQ(items.size(), 1u);
+    EXPECT_EQ(items[0], "widget#42");
+  }
+}
+
+TEST(Db2Wrapper, QueryColumnar) {
+  if (!has_conn_str()) GTEST_SKIP() << "DB2_CONN_STR not set";
+  db2::Connection c;
+  c.connect_with_conn_str(conn_str());
+
+  const char* sql = "SELECT 1 AS ID, 'a' AS NAME, CAST(1.50 AS DECIMAL(10,2)) AS PRICE FROM SYSIBM.SYSDUMMY1 "
+                    "UNION ALL SELECT 2, CAST(NULL AS VARCHAR(10)), CAST(NULL AS DECIMAL(10,2)) FROM SYSIBM.SYSDUMMY1 "
+                    "ORDER BY 1";
+  const db2::ColumnType types[] = {db2::ColumnType::Any, db2::ColumnType::Any, db2::ColumnType::Real};
+  auto r = c.query_columnar(sql, {}, {}, types);
+  ASSERT_EQ(r.rows, 2u);
+  EXPECT_EQ(r.column("ID").ints, (std::vector<std::int64_t>{1, 2}));
+  EXPECT_EQ(r.column("NAME").text(0), "a");
+  EXPECT_TRUE(r.column("NAME").is_null(1));
+  EXPECT_DOUBLE_EQ(r.column("PRICE").reals[0], 1.5);
+  EXPECT_TRUE(r.column("PRICE").is_null(1));
+}
+
+TEST(Db2Wrapper, InstrumentationReportsPhases) {
+  if (!has_conn_str()) GTEST_SKIP() << "DB2_CONN_STR not set";
+  struct Recorder : db2::Instrumentation {
+    std::vector<std::pair<std::string, Phase>> phases;
+    std::uint64_t rows = 0;
+    std::vector<std::string> errors;
+    void on_phase(std::string_view sql, Phase phase, std::chrono::nanoseconds, std::uint64_t n) noexcept override {
+      phases.emplace_back(std::string(sql), phase);
+      rows += n;
+    }
+    void on_error(std::string_view, std::string_view sqlstate) noexcept override { errors.emplace_back(sqlstate); }
+  };
+  auto rec = std::make_shared<Recorder>();
+  db2::Connection c;
+  c.connect_with_conn_str(conn_str());
+  c.set_instrumentation(rec);
+
+  const std::string sql = "SELECT 1 FROM SYSIBM.SYSDUMMY1 WHERE 1 = ?";
+  c.query<int>(sql, {db2::Param{int32_t{1}}}, [](const db2::Connection::Row& r) { return *r.getInt32(1); });
+  using Phase = db2::Instrumentation::Phase;
+  EXPECT_EQ(rec->phases, (std::vector<std::pair<std::string, Phase>>{
+                             {sql, Phase::Prepare}, {sql, Phase::Execute}, {sql, Phase::Fetch}}));
+  EXPECT_EQ(rec->rows, 1u);
+
+  EXPECT_THROW(c.execute("SELECT * FROM NO_SUCH_SCHEMA.NO_SUCH_TABLE"), db2::Error);
+  EXPECT_EQ(rec->errors, (std::vector<std::string>{"42704"}));
+}
+
+TEST(Db2CircuitBreaker, OneProbeOthersWaitOrFailFast) {
+  using Breaker = db2::CircuitBreaker;
+  auto breaker = std::make_shared<Breaker>(Breaker::Options{.initial_backoff = std::chrono::milliseconds(50),
+                                                            .jitter = 0,
+                                                            .probe_wait = std::chrono::milliseconds(500)});
+  EXPECT_TRUE(breaker->enter(true)); // first to see the lost link probes
+  EXPECT_EQ(breaker->state(), Breaker::State::Probing);
+
+  auto waiter = std::async(std::launch::async, [&] { return breaker->enter(true); });
+  std::this_thread::sleep_for(std::chrono::milliseconds(20));
+  breaker->leave(false); // probe failed: the waiter fails too
+  EXPECT_FALSE(waiter.get());
+  EXPECT_EQ(breaker->state(), Breaker::State::Open);
+  EXPECT_FALSE(breaker->enter(false)); // fail fast while open
+
+  std::this_thread::sleep_for(std::chrono::milliseconds(60));
+  EXPECT_TRUE(breaker->enter(true)); // backoff elapsed: probe again
+  breaker->leave(true);
+  EXPECT_EQ(breaker->state(), Breaker::State::Closed);
+  EXPECT_EQ(breaker->consecutive_failures(), 0u);
+}
+
+TEST(Db2CircuitBreaker, SharedPerTarget) {
+  auto a = db2::CircuitBreaker::for_target("DSN=A");
+  EXPECT_EQ(a, db2::CircuitBreaker::for_target("DSN=A"));
+  EXPECT_NE(a, db2::CircuitBreaker::for_target("DSN=B"));
+}
+
+TEST(Db2Error, CarriesFirstRecordAndFormatsAll) {
+  db2::Error err("SQLExecute failed", {{"40001", -911, "deadlock or timeout"}, {"01000", 0, "warning"}});
+  EXPECT_EQ(err.sqlstate(), "40001");
+  EXPECT_EQ(err.native_error(), -911);
+  EXPECT_STREQ(err.context(), "SQLExecute failed");
+  EXPECT_STREQ(err.what(), "SQLExecute failed: [40001] (-911) deadlock or timeout | [01000] (0) warning");
+
+  db2::Error copy = err; // copies share the records
+  EXPECT_EQ(copy.diagnostics().size(), 2u);
+  EXPECT_STREQ(copy.what(), err.what());
+
+  db2::Error empty("SQLFetch failed", {});
+  EXPECT_EQ(empty.sqlstate(), "");
+  EXPECT_EQ(empty.native_error(), 0);
+}
@@ -0,0 +1,101 @@
+// Unit tests for db2::BasicGroupCommitter (no DB2 runtime required: a stand-in
+// connection records transactions instead of talking to a server)
+
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <future>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "db2/group_commit.h"
+
+using namespace std::chrono_literals;
+
+namespace {
+
+struct FakeConnection {
+  std::vector<std::string> pending;
+  std::vector<std::vector<std::string>> committed; // one entry per commit
+  int rollbacks = 0;
+  bool in_txn = false;
+
+  void begin() {
+    if (in_txn) throw std::logic_error("nested begin");
+    in_txn = true;
+  }
+  void commit() {
+    committed.push_back(std::move(pending));
+    pending.clear();
+    in_txn = false;
+  }
+  bool rollback() noexcept {
+    pending.clear();
+    in_txn = false;
+    ++rollbacks;
+    return true;
+  }
+  void write(const std::string& what) {
+    if (what == "bad") throw std::runtime_error("constraint violation");
+    pending.push_back(what);
+  }
+};
+
+using Committer = db2::BasicGroupCommitter<FakeConnection>;
+
+} // namespace
+
+TEST(GroupCommit, BatchesConcurrentWritesIntoOneCommit) {
+  auto conn = std::make_shared<FakeConnection>();
+  std::vector<std::future<void>> done;
+  {
+    Committer committer(conn, {.window = 200ms, .max_batch = 3});
+    for (const char* v : {"a", "b", "c"}) {
+      done.push_back(committer.submit([v](FakeConnection& c) { c.write(v); }));
+    }
+    // max_batch reached: committed without waiting out the window
+    const auto start = std::chrono::steady_clock::now();
+    for (auto& f : done) f.get();
+    EXPECT_LT(std::chrono::steady_clock::now() - start, 150ms);
+
+    auto stats = committer.stats();
+    EXPECT_EQ(stats.commits, 1u);
+    EXPECT_EQ(stats.writes, 3u);
+    EXPECT_EQ(stats.fallbacks, 0u);
+  }
+  ASSERT_EQ(conn->committed.size(), 1u);
+  EXPECT_EQ(conn->committed[0], (std::vector<std::string>{"a", "b", "c"}));
+}
+
+TEST(GroupCommit, FailedWriteDoesNotFailNeighbours) {
+  auto conn = std::make_shared<FakeConnection>();
+  Committer committer(conn, {.window = 200ms, .max_batch = 3});
+  auto a = committer.submit([](FakeConnection& c) { c.write("a"); });
+  auto bad = committer.submit([](FakeConnection& c) { c.write("bad"); });
+  auto b = committer.submit([](FakeConnection& c) { c.write("b"); });
+
+  EXPECT_NO_THROW(a.get());
+  EXPECT_THROW(bad.get(), std::runtime_error);
+  EXPECT_NO_THROW(b.get());
+
+  // Group rolled back, then each write re-run in its own transaction
+  EXPECT_EQ(conn->committed, (std::vector<std::vector<std::string>>{{"a"}, {"b"}}));
+  EXPECT_EQ(conn->rollbacks, 2);
+  auto stats = committer.stats();
+  EXPECT_EQ(stats.fallbacks, 1u);
+  EXPECT_EQ(stats.writes, 2u);
+}
+
+TEST(GroupCommit, DestructorFlushesPendingWrites) {
+  auto conn = std::make_shared<FakeConnection>();
+  std::future<void> done;
+  {
+    Committer committer(conn, {.window = 10s, .max_batch = 64});
+    done = committer.submit([](FakeConnection& c) { c.write("last"); });
+  }
+  ASSERT_EQ(done.wait_for(0s), std::future_status::ready);
+  EXPECT_NO_THROW(done.get());
+  ASSERT_EQ(conn->committed.size(), 1u);
+  EXPECT_EQ(conn->committed[0], (std::vector<std::string>{"last"}));
+}
@@ -0,0 +1,196 @@
+// Unit tests for db2::ResultCache (no DB2 runtime required: a stand-in
+// connection counts the queries that reach it)
+
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <chrono>
+#include <future>
+#include <latch>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <tuple>
+#include <type_traits>
+#include <variant>
+#include <vector>
+
+#include "db2/result_cache.h"
+
+using namespace std::chrono_literals;
+
+namespace {
+
+using Rows = std::vector<std::tuple<int32_t, std::string>>;
+
+struct FakeConnection {
+  std::atomic<int> queries{0};
+  std::chrono::milliseconds delay{0};
+  bool fail = false;
+
+  template <class Tuple>
+  std::vector<Tuple> query_as(std::string_view sql, const std::vector<db2::Param>& params) {
+    ++queries;
+    if (delay > 0ms) std::this_thread::sleep_for(delay);
+    if (fail) throw std::runtime_error("SQL0911N deadlock");
+    int32_t id = 0;
+    if (!params.empty()) {
+      std::visit([&](auto v) {
+        if constexpr (std::is_integral_v<decltype(v)>) id = static_cast<int32_t>(v);
+      }, params[0].value);
+    }
+    return {{id, std::string(sql)}};
+  }
+};
+
+constexpr const char* kSql = "SELECT ID, NAME FROM APP.ITEMS WHERE ID = :id";
+
+} // namespace
+
+TEST(ResultCache, HitsMatchNormalizedSqlAndParameters) {
+  db2::ResultCache cache;
+  FakeConnection conn;
+
+  auto a = cache.query_as<Rows::value_type>(conn, kSql, {db2::Param{int32_t{1}}});
+  // Same statement with a different parameter name normalizes to the same SQL
+  auto b = cache.query_as<Rows::value_type>(conn, "SELECT ID, NAME FROM APP.ITEMS WHERE ID = :item",
+                                            {db2::Param{int32_t{1}}});
+  auto c = cache.query_as<Rows::value_type>(conn, kSql, {db2::Param{int32_t{2}}});
+  // Same value as a different type is a different key
+  auto d = cache.query_as<Rows::value_type>(conn, kSql, {db2::Param{int64_t{1}}}, {});
+
+  EXPECT_EQ(a, b);
+  EXPECT_NE(a, c);
+  EXPECT_EQ(std::get<0>((*c)[0]), 2);
+  (void)d;
+  EXPECT_EQ(conn.queries, 3);
+  auto stats = cache.stats();
+  EXPECT_EQ(stats.hits, 1u);
+  EXPECT_EQ(stats.misses, 3u);
+  EXPECT_EQ(stats.entries, 3u);
+}
+
+TEST(ResultCache, EntriesExpireAfterTtl) {
+  db2::ResultCache cache({.ttl = 20ms});
+  FakeConnection conn;
+  cache.query_as<Rows::value_type>(conn, kSql, {db2::Param{int32_t{1}}});
+  cache.query_as<Rows::value_type>(conn, kSql, {db2::Param{int32_t{1}}});
+  EXPECT_EQ(conn.queries, 1);
+  std::this_thread::sleep_for(40ms);
+  cache.query_as<Rows::value_type>(conn, kSql, {db2::Param{int32_t{1}}});
+  EXPECT_EQ(conn.queries, 2);
+  // Per-query TTL overrides the default
+  cache.query_as<Rows::value_type>(conn, kSql, {db2::Param{int32_t{2}}}, {.ttl = 10s});
+  std::this_thread::sleep_for(40ms);
+  cache.query_as<Rows::value_type>(conn, kSql, {db2::Param{int32_t{2}}});
+  EXPECT_EQ(conn.queries, 3);
+}
+
+TEST(ResultCache, EvictsLeastRecentlyUsedOverByteBudget) {
+  FakeConnection conn;
+  // Measure one entry, then allow room for two
+  std::size_t one = 0;
+  {
+    db2::ResultCache probe;
+    probe.query_as<Rows::value_type>(conn, kSql, {db2::Param{int32_t{1}}});
+    one = probe.stats().bytes;
+  }
+  ASSERT_GT(one, 0u);
+  db2::ResultCache cache({.max_bytes = one * 2 + one / 2});
+  conn.queries = 0;
+
+  cache.query_as<Rows::value_type>(conn, kSql, {db2::Param{int32_t{1}}});
+  cache.query_as<Rows::value_type>(conn, kSql, {db2::Param{int32_t{2}}});
+  cache.query_as<Rows::value_type>(conn, kSql, {db2::Param{int32_t{1}}}); // 1 is now most recent
+  cache.query_as<Rows::value_type>(conn, kSql, {db2::Param{int32_t{3}}}); // evicts 2
+  EXPECT_EQ(conn.queries, 3);
+  EXPECT_EQ(cache.stats().evictions, 1u);
+  EXPECT_LE(cache.stats().bytes, one * 2 + one / 2);
+
+  cache.query_as<Rows::value_type>(conn, kSql, {db2::Param{int32_t{1}}});
+  EXPECT_EQ(conn.queries, 3);
+  cache.query_as<Rows::value_type>(conn, kSql, {db2::Param{int32_t{2}}});
+  EXPECT_EQ(conn.queries, 4);
+}
+
+TEST(ResultCache, CountsEveryHeapAllocatedString) {
+  using db2::result_cache_detail::heap_bytes;
+  const std::string in_object;
+  EXPECT_EQ(heap_bytes(std::string(in_object.capacity(), 'x')), 0u);
+  // Longer strings allocate, including ones shorter than sizeof(std::string)
+  const std::string heap(in_object.capacity() + 1, 'x');
+  EXPECT_EQ(heap_bytes(heap), heap.capacity() + 1);
+}
+
+TEST(ResultCache, ConcurrentMissesRunOneQuery) {
+  db2::ResultCache cache;
+  FakeConnection conn;
+  conn.delay = 50ms;
+
+  constexpr int kCallers = 8;
+  std::latch start(kCallers);
+  std::vector<std::future<std::shared_ptr<const Rows>>> results;
+  for (int i = 0; i < kCallers; ++i) {
+    results.push_back(std::async(std::launch::async, [&] {
+      start.arrive_and_wait();
+      return cache.query_as<Rows::value_type>(conn, kSql, {db2::Param{int32_t{7}}});
+    }));
+  }
+  auto first = results[0].get();
+  for (int i = 1; i < kCallers; ++i) EXPECT_EQ(results[i].get(), first);
+  EXPECT_EQ(conn.queries, 1);
+  EXPECT_EQ(cache.stats().coalesced + cache.stats().hits, static_cast<std::uint64_t>(kCallers - 1));
+}
+
+TEST(ResultCache, FailuresAreSharedButNotCached) {
+  db2::ResultCache cache;
+  FakeConnection conn;
+  conn.fail = true;
+  EXPECT_THROW(cache.query_as<Rows::value_type>(conn, kSql, {db2::Param{int32_t{1}}}), std::runtime_error);
+  conn.fail = false;
+  EXPECT_NO_THROW(cache.query_as<Rows::value_type>(conn, kSql, {db2::Param{int32_t{1}}}));
+  EXPECT_EQ(conn.queries, 2);
+}
+
+TEST(ResultCache, InvalidateByTag) {
+  db2::ResultCache cache;
+  FakeConnection conn;
+  cache.query_as<Rows::value_type>(conn, kSql, {db2::Param{int32_t{1}}}, {.tags = {"APP.ITEMS"}});
+  cache.query_as<Rows::value_type>(conn, "SELECT ID, NAME FROM APP.USERS", {}, {.tags = {"APP.USERS"}});
+
+  cache.invalidate("APP.ITEMS");
+  cache.query_as<Rows::value_type>(conn, kSql, {db2::Param{int32_t{1}}}, {.tags = {"APP.ITEMS"}});
+  cache.query_as<Rows::value_type>(conn, "SELECT ID, NAME FROM APP.USERS", {}, {.tags = {"APP.USERS"}});
+  EXPECT_EQ(conn.queries, 3);
+}
+
+TEST(ResultCache, InvalidationDuringQueryIsNotCached) {
+  db2::ResultCache cache;
+  FakeConnection conn;
+  conn.delay = 50ms;
+  auto pending = std::async(std::launch::async, [&] {
+    return cache.query_as<Rows::value_type>(conn, kSql, {db2::Param{int32_t{1}}}, {.tags = {"APP.ITEMS"}});
+  });
+  while (conn.queries == 0) std::this_thread::yield();
+  cache.invalidate("APP.ITEMS");
+  EXPECT_NE(pending.get(), nullptr);
+
+  conn.delay = 0ms;
+  cache.query_as<Rows::value_type>(conn, kSql, {db2::Param{int32_t{1}}}, {.tags = {"APP.ITEMS"}});
+  EXPECT_EQ(conn.queries, 2);
+}
+
+TEST(ResultCache, PoolIsOnlyUsedOnMiss) {
+  std::atomic<int> created{0};
+  auto pool = resource::ResourcePool<FakeConnection>::create(1, [&] {
+    ++created;
+    return std::make_unique<FakeConnection>();
+  });
+  db2::ResultCache cache;
+  cache.query_as<Rows::value_type>(*pool, kSql, {db2::Param{int32_t{1}}});
+  auto held = pool->acquire(); // a hit must not need a free connection
+  auto rows = cache.query_as<Rows::value_type>(*pool, kSql, {db2::Param{int32_t{1}}});
+  EXPECT_EQ(std::get<0>((*rows)[0]), 1);
+  EXPECT_EQ(created, 1);
+}
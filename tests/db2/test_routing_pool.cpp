@@ -0,0 +1,161 @@
+// Unit tests for db2::BasicRoutingPool (no DB2 runtime required: stand-in
+// connections report which server they belong to and that server's lag)
+
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "db2/routing_pool.h"
+
+using namespace std::chrono_literals;
+
+namespace {
+
+struct FakeServer {
+  std::string name;
+  std::atomic<long long> lag_ms{0};
+  std::atomic<bool> reachable{true};
+};
+
+struct FakeConnection {
+  std::shared_ptr<FakeServer> server;
+};
+
+using Router = db2::BasicRoutingPool<FakeConnection>;
+
+std::shared_ptr<Router::Pool> make_pool(const std::shared_ptr<FakeServer>& server, std::size_t size = 2) {
+  return Router::Pool::create(size, [server] {
+    if (!server->reachable) throw std::runtime_error(server->name + " unreachable");
+    return std::make_unique<FakeConnection>(FakeConnection{server});
+  });
+}
+
+Router::LagProbe server_lag() {
+  return [](FakeConnection& c) -> std::optional<std::chrono::milliseconds> {
+    if (!c.server->reachable) throw std::runtime_error("probe failed");
+    return std::chrono::milliseconds(c.server->lag_ms.load());
+  };
+}
+
+struct RoutingPoolTest : ::testing::Test {
+  std::shared_ptr<FakeServer> primary = std::make_shared<FakeServer>();
+  std::shared_ptr<FakeServer> standby1 = std::make_shared<FakeServer>();
+  std::shared_ptr<FakeServer> standby2 = std::make_shared<FakeServer>();
+
+  void SetUp() override {
+    primary->name = "primary";
+    standby1->name = "standby1";
+    standby2->name = "standby2";
+  }
+
+  Router make_router(Router::Options options) {
+    options.refresh_interval = 0ms; // tests refresh explicitly
+    options.lag_probe = server_lag();
+    return Router(make_pool(primary), {{"s1", make_pool(standby1)}, {"s2", make_pool(standby2)}}, std::move(options));
+  }
+};
+
+} // namespace
+
+TEST_F(RoutingPoolTest, WritesGoToPrimaryAndReadsSpreadOverReplicas) {
+  auto router = make_router({.max_lag = 1000ms});
+
+  EXPECT_EQ(router.acquire_write()->server, primary);
+
+  std::vector<std::string> seen;
+  for (int i = 0; i < 4; ++i) seen.push_back(router.acquire_read()->server->name);
+  EXPECT_EQ(seen, (std::vector<std::string>{"standby1", "standby2", "standby1", "standby2"}));
+
+  auto stats = router.stats();
+  EXPECT_EQ(stats.writes, 1u);
+  EXPECT_EQ(stats.replica_reads, 4u);
+  EXPECT_EQ(stats.primary_reads, 0u);
+}
+
+TEST_F(RoutingPoolTest, LaggingReplicaIsSkippedUntilItCatchesUp) {
+  auto router = make_router({.max_lag = 1000ms});
+  standby1->lag_ms = 5000;
+  router.refresh_lag();
+  EXPECT_EQ(router.replica_lag(0), std::chrono::milliseconds(5000));
+
+  for (int i = 0; i < 3; ++i) EXPECT_EQ(router.acquire_read()->server, standby2);
+  // A caller that tolerates more staleness may still use it
+  bool used_standby1 = false;
+  for (int i = 0; i < 2; ++i) used_standby1 |= router.acquire_read(10s)->server == standby1;
+  EXPECT_TRUE(used_standby1);
+
+  standby1->lag_ms = 0;
+  router.refresh_lag();
+  bool back = false;
+  for (int i = 0; i < 2; ++i) back |= router.acquire_read()->server == standby1;
+  EXPECT_TRUE(back);
+}
+
+TEST_F(RoutingPoolTest, FallsBackToPrimaryWhenNoReplicaQualifies) {
+  auto router = make_router({.max_lag = 1000ms});
+  standby1->lag_ms = 5000;
+  standby2->reachable = false;
+  router.refresh_lag();
+  EXPECT_EQ(router.replica_lag(1), std::nullopt);
+
+  EXPECT_EQ(router.acquire_read()->server, primary);
+  EXPECT_EQ(router.acquire_read()->server, primary);
+  EXPECT_EQ(router.stats().primary_reads, 2u);
+}
+
+TEST_F(RoutingPoolTest, ExhaustedOrFailingReplicaFallsBackWithoutWaiting) {
+  auto router = make_router({.max_lag = 1000ms});
+
+  // Hold every replica connection: reads must not block on them
+  std::vector<std::shared_ptr<FakeConnection>> held;
+  for (int i = 0; i < 4; ++i) held.push_back(router.acquire_read());
+  EXPECT_EQ(router.acquire_read()->server, primary);
+  held.clear();
+
+  // A replica that cannot hand out a new connection is marked unhealthy
+  auto standby3 = std::make_shared<FakeServer>();
+  standby3->name = "standby3";
+  standby3->reachable = false;
+  Router failing(make_pool(primary), {{"s3", make_pool(standby3)}}, {.refresh_interval = 0ms});
+  EXPECT_EQ(failing.acquire_read()->server, primary);
+  EXPECT_EQ(failing.replica_lag(0), std::nullopt);
+  EXPECT_EQ(failing.acquire_read()->server, primary);
+}
+
+TEST_F(RoutingPoolTest, BackgroundRefreshTracksLag) {
+  Router router(make_pool(primary), {{"s1", make_pool(standby1)}},
+                {.max_lag = 1000ms, .refresh_interval = 10ms, .lag_probe = server_lag()});
+  EXPECT_EQ(router.acquire_read()->server, standby1);
+
+  standby1->lag_ms = 5000;
+  const auto deadline = std::chrono::steady_clock::now() + 2s;
+  while (router.replica_lag(0) != std::chrono::milliseconds(5000) && std::chrono::steady_clock::now() < deadline) {
+    std::this_thread::sleep_for(5ms);
+  }
+  EXPECT_EQ(router.replica_lag(0), std::chrono::milliseconds(5000));
+  EXPECT_EQ(router.acquire_read()->server, primary);
+}
+
+TEST_F(RoutingPoolTest, FailedReplicaWithoutProbeRecoversOnRefresh) {
+  standby1->reachable = false;
+  Router router(make_pool(primary), {{"s1", make_pool(standby1)}}, {.refresh_interval = 10ms});
+  EXPECT_EQ(router.acquire_read()->server, primary);
+
+  // Once reachable again, the next refresh lets it back into rotation
+  standby1->reachable = true;
+  const auto deadline = std::chrono::steady_clock::now() + 2s;
+  bool recovered = false;
+  while (!recovered && std::chrono::steady_clock::now() < deadline) {
+    recovered = router.acquire_read()->server == standby1;
+    if (!recovered) std::this_thread::sleep_for(5ms);
+  }
+  EXPECT_TRUE(recovered);
+}
@@ -0,0 +1,808 @@
+// Implementation of the fake DB2 CLI. Handles are integers (as with DB2 CLI
+// on UNIX) mapped to objects in a process-wide registry.
+
+#include "fake_db2cli.h"
+
+#include <algorithm>
+#include <atomic>
+#include <charconv>
+#include <cstdio>
+#include <cstring>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <thread>
+#include <unordered_map>
+
+namespace fake_db2cli {
+namespace {
+
+struct Diag {
+  std::string state;
+  SQLINTEGER native{0};
+  std::string message;
+};
+
+struct Object {
+  SQLSMALLINT type{0};
+  std::vector<Diag> diags;
+};
+
+struct Env : Object {};
+
+struct Dbc : Object {
+  bool connected{false};
+  bool broken{false};
+  bool autocommit{true};
+};
+
+struct ParamBinding {
+  SQLSMALLINT c_type{0};
+  SQLULEN column_size{0}; // declared size; longer character values fail with 22001
+  SQLPOINTER value{nullptr};
+  SQLLEN buffer_len{0};
+  SQLLEN* ind{nullptr};
+};
+
+struct ColBinding {
+  SQLSMALLINT c_type{0};
+  SQLPOINTER value{nullptr};
+  SQLLEN buffer_len{0};
+  SQLLEN* ind{nullptr};
+};
+
+struct Stmt : Object {
+  SQLHDBC dbc{0};
+  std::string sql;
+  bool prepared{false};
+  std::map<SQLUSMALLINT, ParamBinding> params;
+  std::map<SQLUSMALLINT, ColBinding> cols;
+  // Result state
+  bool has_cursor{false};
+  ResultSet result;
+  long row_count{-1};
+  std::size_t next_row{0};     // index of the next row to fetch
+  std::size_t current_row{0};  // row positioned by the last single-row fetch
+  bool positioned{false};
+  std::map<SQLUSMALLINT, std::size_t> get_data_offset;
+  // Attributes
+  SQLULEN row_array_size{1};
+  SQLULEN* rows_fetched{nullptr};
+  SQLUSMALLINT* row_status{nullptr};
+  SQLULEN paramset_size{1};
+  SQLUSMALLINT* param_status{nullptr};
+  SQLULEN* params_processed{nullptr};
+  SQLULEN query_timeout{0};
+  std::atomic<bool> cancel{false};
+};
+
+struct Failure {
+  std::string needle;
+  std::string state;
+  int native{0};
+  int remaining{0};
+};
+
+struct State {
+  std::mutex mu;
+  SQLHANDLE next_handle{1};
+  std::unordered_map<SQLHANDLE, std::shared_ptr<Object>> objects;
+  std::map<std::string, ResultSet, std::less<>> results;
+  Handler handler;
+  Latency latency;
+  std::vector<Failure> failures;
+  int connect_failures{0};
+  std::string connect_failure_state{"08001"};
+  Stats stats;
+};
+
+State& state() {
+  static State s;
+  return s;
+}
+
+template <class T>
+std::shared_ptr<T> lookup(SQLHANDLE h, SQLSMALLINT type) {
+  auto& s = state();
+  std::lock_guard lk(s.mu);
+  auto it = s.objects.find(h);
+  if (it == s.objects.end() || it->second->type != type) {
+    if (h != SQL_NULL_HANDLE) ++s.stats.invalid_handles;
+    return nullptr;
+  }
+  return std::static_pointer_cast<T>(it->second);
+}
+
+SQLRETURN fail(Object& obj, std::string st, SQLINTEGER native, std::string msg) {
+  obj.diags.push_back(Diag{std::move(st), native, std::move(msg)});
+  return SQL_ERROR;
+}
+
+void sleep_for(std::chrono::microseconds d) {
+  if (d.count() > 0) std::this_thread::sleep_for(d);
+}
+
+bool take_failure(std::string_view sql, Diag& out) {
+  auto& s = state();
+  std::lock_guard lk(s.mu);
+  for (auto& f : s.failures) {
+    if (f.remaining > 0 && sql.find(f.needle) != std::string_view::npos) {
+      --f.remaining;
+      out = Diag{f.state, f.native, "[FAKE] injected failure"};
+      return true;
+    }
+  }
+  return false;
+}
+
+std::shared_ptr<Dbc> dbc_of(const Stmt& st) {
+  return lookup<Dbc>(st.dbc, SQL_HANDLE_DBC);
+}
+
+// Returns SQL_SUCCESS when the statement's connection is usable
+SQLRETURN check_link(Stmt& st) {
+  auto dbc = dbc_of(st);
+  if (!dbc || !dbc->connected) return fail(st, "08003", -99999, "[FAKE] connection not open");
+  if (dbc->broken) return fail(st, "08S01", -30081, "[FAKE] communication link failure");
+  return SQL_SUCCESS;
+}
+
+std::string to_text(const Value& v) {
+  if (auto p = std::get_if<int64_t>(&v)) return std::to_string(*p);
+  if (auto p = std::get_if<double>(&v)) {
+    char buf[64];
+    auto [end, ec] = std::to_chars(buf, buf + sizeof(buf), *p);
+    return std::string(buf, end);
+  }
+  if (auto p = std::get_if<std::string>(&v)) return *p;
+  return {};
+}
+
+std::optional<int64_t> to_int(const Value& v) {
+  if (auto p = std::get_if<int64_t>(&v)) return *p;
+  if (auto p = std::get_if<double>(&v)) return static_cast<int64_t>(*p);
+  if (auto p = std::get_if<std::string>(&v)) {
+    int64_t out = 0;
+    auto r = std::from_chars(p->data(), p->data() + p->size(), out);
+    if (r.ec == std::errc{}) return out;
+  }
+  return std::nullopt;
+}
+
+std::optional<double> to_double(const Value& v) {
+  if (auto p = std::get_if<int64_t>(&v)) return static_cast<double>(*p);
+  if (auto p = std::get_if<double>(&v)) return *p;
+  if (auto p = std::get_if<std::string>(&v)) {
+    try { return std::stod(*p); } catch (...) { return std::nullopt; }
+  }
+  return std::nullopt;
+}
+
+std::size_t fixed_size(SQLSMALLINT c_type) {
+  switch (c_type) {
+    case SQL_C_SLONG: return sizeof(int32_t);
+    case SQL_C_SBIGINT: return sizeof(int64_t);
+    case SQL_C_DOUBLE: return sizeof(double);
+    default: return 0;
+  }
+}
+
+// Read parameter `p` for paramset row `row` (column-wise binding)
+Value read_param(const ParamBinding& p, std::size_t row) {
+  SQLLEN ind = p.ind ? p.ind[row] : SQL_NTS;
+  if (ind == SQL_NULL_DATA) return nullptr;
+  const std::size_t fixed = fixed_size(p.c_type);
+  const char* base = static_cast<const char*>(p.value);
+  if (fixed) {
+    const char* at = base + row * fixed;
+    switch (p.c_type) {
+      case SQL_C_SLONG: { int32_t v; std::memcpy(&v, at, sizeof v); return int64_t{v}; }
+      case SQL_C_SBIGINT: { int64_t v; std::memcpy(&v, at, sizeof v); return v; }
+      default: { double v; std::memcpy(&v, at, sizeof v); return v; }
+    }
+  }
+  const char* at = base + row * static_cast<std::size_t>(p.buffer_len);
+  std::size_t len = (ind == SQL_NTS) ? std::strlen(at) : static_cast<std::size_t>(ind);
+  return std::string(at, len);
+}
+
+// Write value into a bound/GetData target. Returns bytes of character data
+// still remaining after this write (0 when complete).
+SQLRETURN write_value(Stmt& st, const Value& v, SQLSMALLINT c_type, char* target,
+                      SQLLEN buffer_len, SQLLEN* ind, std::size_t offset, std::size_t* consumed) {
+  if (std::holds_alternative<std::nullptr_t>(v)) {
+    if (!ind) return fail(st, "22002", -10, "[FAKE] indicator required for NULL");
+    *ind = SQL_NULL_DATA;
+    return SQL_SUCCESS;
+  }
+  switch (c_type) {
+    case SQL_C_SLONG: {
+      auto x = to_int(v);
+      if (!x) return fail(st, "22018", -420, "[FAKE] invalid character value for cast");
+      int32_t y = static_cast<int32_t>(*x);
+      std::memcpy(target, &y, sizeof y);
+      if (ind) *ind = sizeof y;
+      return SQL_SUCCESS;
+    }
+    case SQL_C_SBIGINT: {
+      auto x = to_int(v);
+      if (!x) return fail(st, "22018", -420, "[FAKE] invalid character value for cast");
+      std::memcpy(target, &*x, sizeof *x);
+      if (ind) *ind = sizeof *x;
+      return SQL_SUCCESS;
+    }
+    case SQL_C_DOUBLE: {
+      auto x = to_double(v);
+      if (!x) return fail(st, "22018", -420, "[FAKE] invalid character value for cast");
+      std::memcpy(target, &*x, sizeof *x);
+      if (ind) *ind = sizeof *x;
+      return SQL_SUCCESS;
+    }
+    case SQL_C_CHAR:
+    case SQL_C_BINARY: {
+      // Strings are served in place so chunked reads of large values stay cheap
+      std::string converted;
+      const auto* str = std::get_if<std::string>(&v);
+      const std::string_view text = str ? std::string_view(*str) : std::string_view(converted = to_text(v));
+      const bool is_char = (c_type == SQL_C_CHAR);
+      const std::size_t remaining = text.size() - offset;
+      const std::size_t room = buffer_len > 0
+          ? static_cast<std::size_t>(buffer_len) - (is_char ? 1 : 0) : 0;
+      const std::size_t n = std::min(remaining, room);
+      if (n > 0) std::memcpy(target, text.data() + offset, n);
+      if (is_char && buffer_len > 0) target[n] = '\0';
+      if (ind) *ind = static_cast<SQLLEN>(remaining);
+      if (consumed) *consumed = n;
+      if (n < remaining) {
+        st.diags.push_back(Diag{"01004", 0, "[FAKE] string data, right truncated"});
+        return SQL_SUCCESS_WITH_INFO;
+      }
+      return SQL_SUCCESS;
+    }
+    default:
+      return fail(st, "HYC00", -99999, "[FAKE] unsupported C type");
+  }
+}
+
+ResultSet resolve(std::string_view sql, const std::vector<Value>& params) {
+  auto& s = state();
+  Handler handler;
+  {
+    std::lock_guard lk(s.mu);
+    auto it = s.results.find(sql);
+    if (it != s.results.end()) return it->second;
+    handler = s.handler;
+  }
+  if (handler) return handler(sql, params);
+  return ResultSet{};
+}
+
+// Sleep for `d`, honoring SQLCancel and SQL_ATTR_QUERY_TIMEOUT
+SQLRETURN simulate_work(Stmt& st, std::chrono::microseconds d) {
+  using namespace std::chrono;
+  const auto start = steady_clock::now();
+  const bool has_timeout = st.query_timeout > 0;
+  const auto timeout = duration_cast<microseconds>(seconds(st.query_timeout));
+  while (steady_clock::now() - start < d) {
+    if (st.cancel.exchange(false)) return fail(st, "HY008", -952, "[FAKE] operation canceled");
+    if (has_timeout && steady_clock::now() - start >= timeout) return fail(st, "HYT00", -952, "[FAKE] timeout expired");
+    std::this_thread::sleep_for(std::min<microseconds>(d, microseconds(500)));
+  }
+  st.cancel.store(false);
+  return SQL_SUCCESS;
+}
+
+SQLRETURN run(Stmt& st) {
+  if (SQLRETURN rc = check_link(st); rc != SQL_SUCCESS) return rc;
+  Diag injected;
+  if (take_failure(st.sql, injected)) {
+    st.diags.push_back(injected);
+    return SQL_ERROR;
+  }
+  {
+    auto& s = state();
+    std::lock_guard lk(s.mu);
+    ++s.stats.executes;
+  }
+  if (SQLRETURN rc = simulate_work(st, state().latency.execute); rc != SQL_SUCCESS) return rc;
+
+  const std::size_t sets = std::max<SQLULEN>(st.paramset_size, 1);
+  st.has_cursor = false;
+  st.next_row = 0;
+  st.positioned = false;
+  st.get_data_offset.clear();
+  st.row_count = 0;
+  for (std::size_t r = 0; r < sets; ++r) {
+    std::vector<Value> params;
+    for (auto& [num, p] : st.params) {
+      if (params.size() < num) params.resize(num);
+      params[num - 1] = read_param(p, r);
+      const auto* text = std::get_if<std::string>(&params[num - 1]);
+      if (text && text->size() > p.column_size) {
+        return fail(st, "22001", -302, "[FAKE] string data, right truncation");
+      }
+    }
+    st.result = resolve(st.sql, params);
+    if (st.param_status) st.param_status[r] = SQL_PARAM_SUCCESS;
+    st.row_count += st.result.rows_affected >= 0 ? st.result.rows_affected : 1;
+  }
+  {
+    auto& s = state();
+    std::lock_guard lk(s.mu);
+    s.stats.paramsets += sets;
+  }
+  if (st.params_processed) *st.params_processed = sets;
+  if (!st.result.columns.empty()) {
+    st.has_cursor = true;
+    st.row_count = -1;
+  }
+  return SQL_SUCCESS;
+}
+
+SQLRETURN fetch_one(Stmt& st, std::size_t row, std::size_t slot) {
+  SQLRETURN out = SQL_SUCCESS;
+  for (auto& [num, b] : st.cols) {
+    if (num == 0 || num > st.result.columns.size()) continue;
+    const Value& v = st.result.rows[row][num - 1];
+    const std::size_t elem = fixed_size(b.c_type) ? fixed_size(b.c_type) : static_cast<std::size_t>(b.buffer_len);
+    char* target = static_cast<char*>(b.value) + slot * elem;
+    SQLLEN* ind = b.ind ? b.ind + slot : nullptr;
+    SQLRETURN rc = write_value(st, v, b.c_type, target, b.buffer_len, ind, 0, nullptr);
+    if (rc == SQL_ERROR) return rc;
+    if (rc == SQL_SUCCESS_WITH_INFO) out = rc;
+  }
+  return out;
+}
+
+SQLHANDLE register_object(std::shared_ptr<Object> obj) {
+  auto& s = state();
+  std::lock_guard lk(s.mu);
+  SQLHANDLE h = s.next_handle++;
+  if (obj->type == SQL_HANDLE_STMT) ++s.stats.live_statements;
+  if (obj->type == SQL_HANDLE_ENV) ++s.stats.env_allocs;
+  s.objects.emplace(h, std::move(obj));
+  return h;
+}
+
+void free_statements_of(SQLHDBC dbc) {
+  auto& s = state();
+  std::lock_guard lk(s.mu);
+  for (auto it = s.objects.begin(); it != s.objects.end();) {
+    if (it->second->type == SQL_HANDLE_STMT && static_cast<Stmt&>(*it->second).dbc == dbc) {
+      --s.stats.live_statements;
+      it = s.objects.erase(it);
+    } else {
+      ++it;
+    }
+  }
+}
+
+SQLRETURN do_connect(SQLHDBC hdbc) {
+  auto dbc = lookup<Dbc>(hdbc, SQL_HANDLE_DBC);
+  if (!dbc) return SQL_INVALID_HANDLE;
+  dbc->diags.clear();
+  sleep_for(state().latency.connect);
+  auto& s = state();
+  {
+    std::lock_guard lk(s.mu);
+    if (s.connect_failures > 0) {
+      --s.connect_failures;
+      ++s.stats.connect_failures;
+      return fail(*dbc, s.connect_failure_state, -30081, "[FAKE] connection refused");
+    }
+    ++s.stats.connects;
+  }
+  dbc->connected = true;
+  dbc->broken = false;
+  return SQL_SUCCESS;
+}
+
+} // namespace
+
+void reset() {
+  auto& s = state();
+  std::lock_guard lk(s.mu);
+  s.results.clear();
+  s.handler = nullptr;
+  s.latency = Latency{};
+  s.failures.clear();
+  s.connect_failures = 0;
+  const auto live = s.stats.live_statements;
+  s.stats = Stats{};
+  s.stats.live_statements = live;
+}
+
+void set_result(std::string sql, ResultSet rs) {
+  auto& s = state();
+  std::lock_guard lk(s.mu);
+  s.results[std::move(sql)] = std::move(rs);
+}
+
+void set_handler(Handler handler) {
+  auto& s = state();
+  std::lock_guard lk(s.mu);
+  s.handler = std::move(handler);
+}
+
+void set_latency(const Latency& latency) {
+  auto& s = state();
+  std::lock_guard lk(s.mu);
+  s.latency = latency;
+}
+
+void inject_failure(std::string sql_substring, std::string sqlstate, int native_error, int count) {
+  auto& s = state();
+  std::lock_guard lk(s.mu);
+  s.failures.push_back(Failure{std::move(sql_substring), std::move(sqlstate), native_error, count});
+}
+
+void fail_connects(int count, std::string sqlstate) {
+  auto& s = state();
+  std::lock_guard lk(s.mu);
+  s.connect_failures = count;
+  s.connect_failure_state = std::move(sqlstate);
+}
+
+void drop_connections() {
+  auto& s = state();
+  std::lock_guard lk(s.mu);
+  for (auto& [h, obj] : s.objects) {
+    if (obj->type == SQL_HANDLE_DBC) {
+      auto& dbc = static_cast<Dbc&>(*obj);
+      if (dbc.connected) dbc.broken = true;
+    }
+  }
+}
+
+Stats stats() {
+  auto& s = state();
+  std::lock_guard lk(s.mu);
+  return s.stats;
+}
+
+} // namespace fake_db2cli
+
+using namespace fake_db2cli;
+
+extern "C" {
+
+SQLRETURN SQLAllocHandle(SQLSMALLINT type, SQLHANDLE input, SQLHANDLE* output) {
+  if (!output) return SQL_ERROR;
+  switch (type) {
+    case SQL_HANDLE_ENV: {
+      auto env = std::make_shared<Env>();
+      env->type = SQL_HANDLE_ENV;
+      *output = register_object(env);
+      return SQL_SUCCESS;
+    }
+    case SQL_HANDLE_DBC: {
+      if (!lookup<Env>(input, SQL_HANDLE_ENV)) return SQL_INVALID_HANDLE;
+      auto dbc = std::make_shared<Dbc>();
+      dbc->type = SQL_HANDLE_DBC;
+      *output = register_object(dbc);
+      return SQL_SUCCESS;
+    }
+    case SQL_HANDLE_STMT: {
+      auto dbc = lookup<Dbc>(input, SQL_HANDLE_DBC);
+      if (!dbc) return SQL_INVALID_HANDLE;
+      dbc->diags.clear();
+      if (!dbc->connected) return fail(*dbc, "08003", -99999, "[FAKE] connection not open");
+      if (dbc->broken) return fail(*dbc, "08S01", -30081, "[FAKE] communication link failure");
+      auto st = std::make_shared<Stmt>();
+      st->type = SQL_HANDLE_STMT;
+      st->dbc = input;
+      *output = register_object(st);
+      return SQL_SUCCESS;
+    }
+    default:
+      return SQL_ERROR;
+  }
+}
+
+SQLRETURN SQLFreeHandle(SQLSMALLINT type, SQLHANDLE handle) {
+  auto& s = state();
+  std::lock_guard lk(s.mu);
+  auto it = s.objects.find(handle);
+  if (it == s.objects.end() || it->second->type != type) return SQL_INVALID_HANDLE;
+  if (type == SQL_HANDLE_STMT) --s.stats.live_statements;
+  s.objects.erase(it);
+  return SQL_SUCCESS;
+}
+
+SQLRETURN SQLSetEnvAttr(SQLHENV henv, SQLINTEGER, SQLPOINTER, SQLINTEGER) {
+  return lookup<Env>(henv, SQL_HANDLE_ENV) ? SQL_SUCCESS : SQL_INVALID_HANDLE;
+}
+
+SQLRETURN SQLSetConnectAttr(SQLHDBC hdbc, SQLINTEGER attr, SQLPOINTER value, SQLINTEGER) {
+  auto dbc = lookup<Dbc>(hdbc, SQL_HANDLE_DBC);
+  if (!dbc) return SQL_INVALID_HANDLE;
+  dbc->diags.clear();
+  if (attr == SQL_ATTR_AUTOCOMMIT) {
+    if (dbc->broken) return fail(*dbc, "08S01", -30081, "[FAKE] communication link failure");
+    dbc->autocommit = reinterpret_cast<SQLULEN>(value) == SQL_AUTOCOMMIT_ON;
+  }
+  return SQL_SUCCESS;
+}
+
+SQLRETURN SQLGetConnectAttr(SQLHDBC hdbc, SQLINTEGER attr, SQLPOINTER value, SQLINTEGER, SQLINTEGER*) {
+  auto dbc = lookup<Dbc>(hdbc, SQL_HANDLE_DBC);
+  if (!dbc) return SQL_INVALID_HANDLE;
+  if (attr == SQL_ATTR_AUTOCOMMIT && value) {
+    *static_cast<SQLUINTEGER*>(value) = dbc->autocommit ? SQL_AUTOCOMMIT_ON : SQL_AUTOCOMMIT_OFF;
+  }
+  return SQL_SUCCESS;
+}
+
+SQLRETURN SQLConnect(SQLHDBC hdbc, SQLCHAR*, SQLSMALLINT, SQLCHAR*, SQLSMALLINT, SQLCHAR*, SQLSMALLINT) {
+  return do_connect(hdbc);
+}
+
+SQLRETURN SQLDriverConnect(SQLHDBC hdbc, SQLHWND, SQLCHAR*, SQLSMALLINT, SQLCHAR* out, SQLSMALLINT out_max,
+                           SQLSMALLINT* out_len, SQLUSMALLINT) {
+  SQLRETURN rc = do_connect(hdbc);
+  if (rc == SQL_SUCCESS) {
+    if (out && out_max > 0) out[0] = '\0';
+    if (out_len) *out_len = 0;
+  }
+  return rc;
+}
+
+SQLRETURN SQLDisconnect(SQLHDBC hdbc) {
+  auto dbc = lookup<Dbc>(hdbc, SQL_HANDLE_DBC);
+  if (!dbc) return SQL_INVALID_HANDLE;
+  dbc->diags.clear();
+  if (dbc->connected) {
+    std::lock_guard lk(state().mu);
+    ++state().stats.disconnects;
+  }
+  dbc->connected = false;
+  dbc->broken = false;
+  // Like DB2 CLI, disconnect frees statements still allocated on the DBC
+  free_statements_of(hdbc);
+  return SQL_SUCCESS;
+}
+
+SQLRETURN SQLEndTran(SQLSMALLINT type, SQLHANDLE handle, SQLSMALLINT completion) {
+  if (type != SQL_HANDLE_DBC) return SQL_ERROR;
+  auto dbc = lookup<Dbc>(handle, SQL_HANDLE_DBC);
+  if (!dbc) return SQL_INVALID_HANDLE;
+  dbc->diags.clear();
+  if (dbc->broken) return fail(*dbc, "08S01", -30081, "[FAKE] communication link failure");
+  std::lock_guard lk(state().mu);
+  if (completion == SQL_COMMIT) ++state().stats.commits; else ++state().stats.rollbacks;
+  return SQL_SUCCESS;
+}
+
+SQLRETURN SQLSetStmtAttr(SQLHSTMT hstmt, SQLINTEGER attr, SQLPOINTER value, SQLINTEGER) {
+  auto st = lookup<Stmt>(hstmt, SQL_HANDLE_STMT);
+  if (!st) return SQL_INVALID_HANDLE;
+  st->diags.clear();
+  const auto as_uint = reinterpret_cast<SQLULEN>(value);
+  switch (attr) {
+    case SQL_ATTR_ROW_ARRAY_SIZE: st->row_array_size = as_uint ? as_uint : 1; break;
+    case SQL_ATTR_ROWS_FETCHED_PTR: st->rows_fetched = static_cast<SQLULEN*>(value); break;
+    case SQL_ATTR_ROW_STATUS_PTR: st->row_status = static_cast<SQLUSMALLINT*>(value); break;
+    case SQL_ATTR_PARAMSET_SIZE: st->paramset_size = as_uint ? as_uint : 1; break;
+    case SQL_ATTR_PARAM_STATUS_PTR: st->param_status = static_cast<SQLUSMALLINT*>(value); break;
+    case SQL_ATTR_PARAMS_PROCESSED_PTR: st->params_processed = static_cast<SQLULEN*>(value); break;
+    case SQL_ATTR_QUERY_TIMEOUT: st->query_timeout = as_uint; break;
+    default: break;
+  }
+  return SQL_SUCCESS;
+}
+
+SQLRETURN SQLExecDirect(SQLHSTMT hstmt, SQLCHAR* sql, SQLINTEGER len) {
+  auto st = lookup<Stmt>(hstmt, SQL_HANDLE_STMT);
+  if (!st) return SQL_INVALID_HANDLE;
+  st->diags.clear();
+  const char* text = reinterpret_cast<const char*>(sql);
+  st->sql.assign(text, len == SQL_NTS ? std::strlen(text) : static_cast<std::size_t>(len));
+  st->prepared = false;
+  return run(*st);
+}
+
+SQLRETURN SQLPrepare(SQLHSTMT hstmt, SQLCHAR* sql, SQLINTEGER len) {
+  auto st = lookup<Stmt>(hstmt, SQL_HANDLE_STMT);
+  if (!st) return SQL_INVALID_HANDLE;
+  st->diags.clear();
+  if (SQLRETURN rc = check_link(*st); rc != SQL_SUCCESS) return rc;
+  const char* text = reinterpret_cast<const char*>(sql);
+  st->sql.assign(text, len == SQL_NTS ? std::strlen(text) : static_cast<std::size_t>(len));
+  Diag injected;
+  if (take_failure(st->sql, injected)) {
+    st->diags.push_back(injected);
+    return SQL_ERROR;
+  }
+  {
+    std::lock_guard lk(state().mu);
+    ++state().stats.prepares;
+  }
+  sleep_for(state().latency.prepare);
+  st->prepared = true;
+  st->has_cursor = false;
+  return SQL_SUCCESS;
+}
+
+SQLRETURN SQLBindParameter(SQLHSTMT hstmt, SQLUSMALLINT num, SQLSMALLINT, SQLSMALLINT c_type, SQLSMALLINT,
+                           SQLULEN column_size, SQLSMALLINT, SQLPOINTER value, SQLLEN buffer_len, SQLLEN* ind) {
+  auto st = lookup<Stmt>(hstmt, SQL_HANDLE_STMT);
+  if (!st) return SQL_INVALID_HANDLE;
+  st->diags.clear();
+  if (num == 0) return fail(*st, "07009", -99999, "[FAKE] invalid parameter number");
+  st->params[num] = ParamBinding{c_type, column_size, value, buffer_len, ind};
+  return SQL_SUCCESS;
+}
+
+SQLRETURN SQLExecute(SQLHSTMT hstmt) {
+  auto st = lookup<Stmt>(hstmt, SQL_HANDLE_STMT);
+  if (!st) return SQL_INVALID_HANDLE;
+  st->diags.clear();
+  if (!st->prepared) return fail(*st, "HY010", -99999, "[FAKE] function sequence error");
+  if (st->has_cursor) return fail(*st, "24000", -99999, "[FAKE] invalid cursor state");
+  return run(*st);
+}
+
+SQLRETURN SQLNumResultCols(SQLHSTMT hstmt, SQLSMALLINT* count) {
+  auto st = lookup<Stmt>(hstmt, SQL_HANDLE_STMT);
+  if (!st) return SQL_INVALID_HANDLE;
+  st->diags.clear();
+  if (!st->has_cursor && st->prepared) st->result = resolve(st->sql, {});
+  if (count) *count = static_cast<SQLSMALLINT>(st->result.columns.size());
+  return SQL_SUCCESS;
+}
+
+SQLRETURN SQLDescribeCol(SQLHSTMT hstmt, SQLUSMALLINT col, SQLCHAR* name, SQLSMALLINT name_max, SQLSMALLINT* name_len,
+                         SQLSMALLINT* type, SQLULEN* size, SQLSMALLINT* digits, SQLSMALLINT* nullable) {
+  auto st = lookup<Stmt>(hstmt, SQL_HANDLE_STMT);
+  if (!st) return SQL_INVALID_HANDLE;
+  st->diags.clear();
+  if (col == 0 || col > st->result.columns.size()) return fail(*st, "07009", -99999, "[FAKE] invalid column number");
+  const Column& c = st->result.columns[col - 1];
+  if (name && name_max > 0) {
+    const std::size_t n = std::min<std::size_t>(c.name.size(), static_cast<std::size_t>(name_max - 1));
+    std::memcpy(name, c.name.data(), n);
+    name[n] = '\0';
+  }
+  if (name_len) *name_len = static_cast<SQLSMALLINT>(c.name.size());
+  if (type) *type = c.sql_type;
+  if (size) *size = c.size;
+  if (digits) *digits = c.decimal_digits;
+  if (nullable) *nullable = c.nullable ? SQL_NULLABLE : SQL_NO_NULLS;
+  return SQL_SUCCESS;
+}
+
+SQLRETURN SQLBindCol(SQLHSTMT hstmt, SQLUSMALLINT col, SQLSMALLINT c_type, SQLPOINTER value, SQLLEN buffer_len, SQLLEN* ind) {
+  auto st = lookup<Stmt>(hstmt, SQL_HANDLE_STMT);
+  if (!st) return SQL_INVALID_HANDLE;
+  st->diags.clear();
+  if (!value) st->cols.erase(col);
+  else st->cols[col] = ColBinding{c_type, value, buffer_len, ind};
+  return SQL_SUCCESS;
+}
+
+SQLRETURN SQLFetch(SQLHSTMT hstmt) {
+  auto st = lookup<Stmt>(hstmt, SQL_HANDLE_STMT);
+  if (!st) return SQL_INVALID_HANDLE;
+  st->diags.clear();
+  if (!st->has_cursor) return fail(*st, "24000", -99999, "[FAKE] invalid cursor state");
+  if (SQLRETURN rc = check_link(*st); rc != SQL_SUCCESS) return rc;
+  {
+    std::lock_guard lk(state().mu);
+    ++state().stats.fetches;
+  }
+  if (SQLRETURN rc = simulate_work(*st, state().latency.fetch); rc != SQL_SUCCESS) return rc;
+  st->get_data_offset.clear();
+  const std::size_t total = st->result.rows.size();
+  if (st->next_row >= total) {
+    if (st->rows_fetched) *st->rows_fetched = 0;
+    return SQL_NO_DATA;
+  }
+  const std::size_t n = std::min<std::size_t>(st->row_array_size, total - st->next_row);
+  SQLRETURN out = SQL_SUCCESS;
+  for (std::size_t i = 0; i < n; ++i) {
+    SQLRETURN rc = fetch_one(*st, st->next_row + i, i);
+    if (rc == SQL_ERROR) return rc;
+    if (rc == SQL_SUCCESS_WITH_INFO) out = rc;
+    if (st->row_status) st->row_status[i] = (rc == SQL_SUCCESS) ? SQL_ROW_SUCCESS : SQL_ROW_SUCCESS_WITH_INFO;
+  }
+  if (st->row_status) {
+    for (std::size_t i = n; i < st->row_array_size; ++i) st->row_status[i] = SQL_ROW_NOROW;
+  }
+  if (st->rows_fetched) *st->rows_fetched = n;
+  st->current_row = st->next_row;
+  st->positioned = true;
+  st->next_row += n;
+  return out;
+}
+
+SQLRETURN SQLGetData(SQLHSTMT hstmt, SQLUSMALLINT col, SQLSMALLINT c_type, SQLPOINTER value, SQLLEN buffer_len, SQLLEN* ind) {
+  auto st = lookup<Stmt>(hstmt, SQL_HANDLE_STMT);
+  if (!st) return SQL_INVALID_HANDLE;
+  st->diags.clear();
+  if (!st->positioned) return fail(*st, "24000", -99999, "[FAKE] invalid cursor state");
+  if (col == 0 || col > st->result.columns.size()) return fail(*st, "07009", -99999, "[FAKE] invalid column number");
+  {
+    std::lock_guard lk(state().mu);
+    ++state().stats.get_data;
+  }
+  sleep_for(state().latency.get_data);
+  const Value& v = st->result.rows[st->current_row][col - 1];
+  // Offset into character data already returned; npos once the column is exhausted
+  constexpr std::size_t done = static_cast<std::size_t>(-1);
+  std::size_t& offset = st->get_data_offset[col];
+  if (offset == done) return SQL_NO_DATA;
+  std::size_t consumed = 0;
+  SQLRETURN rc = write_value(*st, v, c_type, static_cast<char*>(value), buffer_len, ind, offset, &consumed);
+  const bool chunked = (c_type == SQL_C_CHAR || c_type == SQL_C_BINARY);
+  offset = (chunked && rc == SQL_SUCCESS_WITH_INFO) ? offset + consumed : done;
+  return rc;
+}
+
+SQLRETURN SQLRowCount(SQLHSTMT hstmt, SQLLEN* count) {
+  auto st = lookup<Stmt>(hstmt, SQL_HANDLE_STMT);
+  if (!st) return SQL_INVALID_HANDLE;
+  if (count) *count = st->row_count;
+  return SQL_SUCCESS;
+}
+
+SQLRETURN SQLCloseCursor(SQLHSTMT hstmt) {
+  auto st = lookup<Stmt>(hstmt, SQL_HANDLE_STMT);
+  if (!st) return SQL_INVALID_HANDLE;
+  st->diags.clear();
+  if (!st->has_cursor) return fail(*st, "24000", -99999, "[FAKE] invalid cursor state");
+  st->has_cursor = false;
+  st->positioned = false;
+  return SQL_SUCCESS;
+}
+
+SQLRETURN SQLFreeStmt(SQLHSTMT hstmt, SQLUSMALLINT option) {
+  auto st = lookup<Stmt>(hstmt, SQL_HANDLE_STMT);
+  if (!st) return SQL_INVALID_HANDLE;
+  st->diags.clear();
+  switch (option) {
+    case SQL_CLOSE: st->has_cursor = false; st->positioned = false; break;
+    case SQL_UNBIND: st->cols.clear(); break;
+    case SQL_RESET_PARAMS: st->params.clear(); break;
+    case SQL_DROP: return SQLFreeHandle(SQL_HANDLE_STMT, hstmt);
+    default: return fail(*st, "HY092", -99999, "[FAKE] invalid option");
+  }
+  return SQL_SUCCESS;
+}
+
+SQLRETURN SQLCancel(SQLHSTMT hstmt) {
+  auto st = lookup<Stmt>(hstmt, SQL_HANDLE_STMT);
+  if (!st) return SQL_INVALID_HANDLE;
+  st->cancel.store(true);
+  std::lock_guard lk(state().mu);
+  ++state().stats.cancels;
+  return SQL_SUCCESS;
+}
+
+SQLRETURN SQLGetDiagRec(SQLSMALLINT type, SQLHANDLE handle, SQLSMALLINT rec, SQLCHAR* sqlstate, SQLINTEGER* native,
+                        SQLCHAR* text, SQLSMALLINT text_max, SQLSMALLINT* text_len) {
+  std::shared_ptr<Object> obj;
+  {
+    auto& s = state();
+    std::lock_guard lk(s.mu);
+    auto it = s.objects.find(handle);
+    if (it == s.objects.end() || it->second->type != type) return SQL_INVALID_HANDLE;
+    obj = it->second;
+  }
+  if (rec < 1 || static_cast<std::size_t>(rec) > obj->diags.size()) return SQL_NO_DATA;
+  const Diag& d = obj->diags[rec - 1];
+  if (sqlstate) {
+    std::memset(sqlstate, 0, 6);
+    std::memcpy(sqlstate, d.state.data(), std::min<std::size_t>(d.state.size(), 5));
+  }
+  if (native) *native = d.native;
+  if (text && text_max > 0) {
+    const std::size_t n = std::min<std::size_t>(d.message.size(), static_cast<std::size_t>(text_max - 1));
+    std::memcpy(text, d.message.data(), n);
+    text[n] = '\0';
+  }
+  if (text_len) *text_len = static_cast<SQLSMALLINT>(d.message.size());
+  return SQL_SUCCESS;
+}
+
+} // extern "C"
@@ -0,0 +1,102 @@
+// fake_db2cli.h
+// In-process stand-in for the subset of the IBM DB2 CLI used by
+// db2::Connection, so the wrapper can be tested and benchmarked without a
+// server or the IBM driver. Built as the `fake_db2cli` library and linked in
+// place of DB2::db2 when configuring with -DDB2_USE_FAKE_CLI=ON.
+//
+// Tests and benchmarks script the "server" through the control API below:
+//
+//   fake_db2cli::reset();
+//   fake_db2cli::set_result("SELECT ID FROM T", {{{"ID", SQL_INTEGER, 10}}, {{int64_t{1}}, {int64_t{2}}}});
+//   fake_db2cli::set_latency({.execute = std::chrono::microseconds(200)});
+//   fake_db2cli::inject_failure("UPDATE", "40001", -911);   // next UPDATE deadlocks
+//   fake_db2cli::drop_connections();                       // next call fails with 08S01
+//
+// Character parameters are read with their length indicator and fail with
+// SQLSTATE 22001 when longer than the ColumnSize they were bound with.
+//
+// State is process-wide; call reset() between test cases.
+
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <string_view>
+#include <variant>
+#include <vector>
+
+#include <sqlcli1.h>
+
+namespace fake_db2cli {
+
+using Value = std::variant<std::nullptr_t, int64_t, double, std::string>;
+
+struct Column {
+  std::string name;
+  SQLSMALLINT sql_type{SQL_VARCHAR};
+  SQLULEN size{0};
+  SQLSMALLINT decimal_digits{0};
+  bool nullable{true};
+};
+
+struct ResultSet {
+  std::vector<Column> columns;             // empty => statement has no result set
+  std::vector<std::vector<Value>> rows;
+  long rows_affected{-1};                  // reported by SQLRowCount for DML (-1 => per paramset)
+};
+
+// Produces the result of a statement. Called with empty params when only
+// metadata is needed (SQLNumResultCols/SQLDescribeCol after SQLPrepare).
+using Handler = std::function<ResultSet(std::string_view sql, const std::vector<Value>& params)>;
+
+// Simulated server-side latency per CLI call
+struct Latency {
+  std::chrono::microseconds connect{0};
+  std::chrono::microseconds prepare{0};
+  std::chrono::microseconds execute{0};
+  std::chrono::microseconds fetch{0};
+  std::chrono::microseconds get_data{0};
+};
+
+struct Stats {
+  uint64_t connects{0};
+  uint64_t connect_failures{0};
+  uint64_t disconnects{0};
+  uint64_t prepares{0};
+  uint64_t executes{0};        // SQLExecute + SQLExecDirect
+  uint64_t fetches{0};
+  uint64_t get_data{0};
+  uint64_t commits{0};
+  uint64_t rollbacks{0};
+  uint64_t cancels{0};
+  uint64_t env_allocs{0};
+  uint64_t live_statements{0};
+  uint64_t paramsets{0};       // parameter sets processed by SQLExecute
+  uint64_t invalid_handles{0}; // calls on freed or unknown handles
+};
+
+// Restore defaults: no results, no latency, no failures, zeroed stats.
+void reset();
+
+// Register a fixed result for an exact SQL text.
+void set_result(std::string sql, ResultSet rs);
+
+// Fallback for SQL without a registered result.
+void set_handler(Handler handler);
+
+void set_latency(const Latency& latency);
+
+// Fail the next `count` prepare/execute calls whose SQL contains `sql_substring`.
+void inject_failure(std::string sql_substring, std::string sqlstate, int native_error, int count = 1);
+
+// Fail the next `count` SQLConnect/SQLDriverConnect calls.
+void fail_connects(int count, std::string sqlstate = "08001");
+
+// Mark every connected DBC as broken; statements then fail with 08S01.
+void drop_connections();
+
+Stats stats();
+
+} // namespace fake_db2cli
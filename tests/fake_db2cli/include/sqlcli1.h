@@ -0,0 +1,157 @@
+// sqlcli1.h (fake)
+// Declarations for the subset of the IBM DB2 CLI that src/db2/db2.cpp uses,
+// implemented in-process by fake_db2cli.cpp. Type widths and constant values
+// follow the DB2 CLI headers for 64-bit UNIX so the wrapper compiles
+// unchanged against either. Selected by -DDB2_USE_FAKE_CLI=ON.
+
+#pragma once
+
+#include <cstdint>
+
+typedef short SQLSMALLINT;
+typedef unsigned short SQLUSMALLINT;
+typedef int SQLINTEGER;
+typedef unsigned int SQLUINTEGER;
+typedef long SQLLEN;
+typedef unsigned long SQLULEN;
+typedef SQLSMALLINT SQLRETURN;
+typedef void* SQLPOINTER;
+typedef unsigned char SQLCHAR;
+typedef SQLINTEGER SQLHANDLE;
+typedef SQLHANDLE SQLHENV;
+typedef SQLHANDLE SQLHDBC;
+typedef SQLHANDLE SQLHSTMT;
+typedef void* SQLHWND;
+
+#define SQL_SUCCESS 0
+#define SQL_SUCCESS_WITH_INFO 1
+#define SQL_STILL_EXECUTING 2
+#define SQL_NO_DATA 100
+#define SQL_NO_DATA_FOUND 100
+#define SQL_ERROR (-1)
+#define SQL_INVALID_HANDLE (-2)
+
+#define SQL_HANDLE_ENV 1
+#define SQL_HANDLE_DBC 2
+#define SQL_HANDLE_STMT 3
+#define SQL_NULL_HANDLE 0
+
+#define SQL_ATTR_ODBC_VERSION 200
+#define SQL_OV_ODBC3 3UL
+
+#define SQL_NTS (-3)
+#define SQL_NULL_DATA (-1)
+#define SQL_NO_TOTAL (-4)
+
+#define SQL_CHAR 1
+#define SQL_NUMERIC 2
+#define SQL_DECIMAL 3
+#define SQL_INTEGER 4
+#define SQL_SMALLINT 5
+#define SQL_FLOAT 6
+#define SQL_REAL 7
+#define SQL_DOUBLE 8
+#define SQL_VARCHAR 12
+#define SQL_TYPE_DATE 91
+#define SQL_TYPE_TIME 92
+#define SQL_TYPE_TIMESTAMP 93
+#define SQL_LONGVARCHAR (-1)
+#define SQL_BINARY (-2)
+#define SQL_VARBINARY (-3)
+#define SQL_LONGVARBINARY (-4)
+#define SQL_BIGINT (-5)
+#define SQL_TINYINT (-6)
+#define SQL_BIT (-7)
+#define SQL_WCHAR (-8)
+#define SQL_WVARCHAR (-9)
+#define SQL_WLONGVARCHAR (-10)
+#define SQL_GRAPHIC (-95)
+#define SQL_VARGRAPHIC (-96)
+#define SQL_LONGVARGRAPHIC (-97)
+#define SQL_BLOB (-98)
+#define SQL_CLOB (-99)
+#define SQL_DBCLOB (-350)
+#define SQL_DECFLOAT (-360)
+#define SQL_XML (-370)
+
+#define SQL_C_CHAR SQL_CHAR
+#define SQL_C_SLONG (-16)
+#define SQL_C_SBIGINT (-25)
+#define SQL_C_DOUBLE SQL_DOUBLE
+#define SQL_C_BINARY SQL_BINARY
+
+#define SQL_PARAM_INPUT 1
+#define SQL_DRIVER_NOPROMPT 0
+
+#define SQL_CLOSE 0
+#define SQL_DROP 1
+#define SQL_UNBIND 2
+#define SQL_RESET_PARAMS 3
+
+#define SQL_ATTR_QUERY_TIMEOUT 0
+#define SQL_ATTR_ASYNC_ENABLE 4
+#define SQL_ATTR_ROW_BIND_TYPE 5
+#define SQL_BIND_BY_COLUMN 0UL
+#define SQL_ATTR_PARAM_BIND_TYPE 18
+#define SQL_PARAM_BIND_BY_COLUMN 0UL
+#define SQL_ATTR_PARAM_STATUS_PTR 20
+#define SQL_ATTR_PARAMS_PROCESSED_PTR 21
+#define SQL_ATTR_PARAMSET_SIZE 22
+#define SQL_ATTR_ROW_STATUS_PTR 25
+#define SQL_ATTR_ROWS_FETCHED_PTR 26
+#define SQL_ATTR_ROW_ARRAY_SIZE 27
+
+#define SQL_ROW_SUCCESS 0
+#define SQL_ROW_NOROW 3
+#define SQL_ROW_ERROR 5
+#define SQL_ROW_SUCCESS_WITH_INFO 6
+
+#define SQL_PARAM_SUCCESS 0
+#define SQL_PARAM_DIAG_UNAVAILABLE 1
+#define SQL_PARAM_ERROR 5
+#define SQL_PARAM_SUCCESS_WITH_INFO 6
+#define SQL_PARAM_UNUSED 7
+
+#define SQL_ATTR_AUTOCOMMIT 102
+#define SQL_AUTOCOMMIT_OFF 0UL
+#define SQL_AUTOCOMMIT_ON 1UL
+
+#define SQL_COMMIT 0
+#define SQL_ROLLBACK 1
+
+#define SQL_NO_NULLS 0
+#define SQL_NULLABLE 1
+#define SQL_NULLABLE_UNKNOWN 2
+
+#define SQL_IS_POINTER (-4)
+#define SQL_IS_UINTEGER (-5)
+#define SQL_IS_INTEGER (-6)
+
+extern "C" {
+
+SQLRETURN SQLAllocHandle(SQLSMALLINT, SQLHANDLE, SQLHANDLE*);
+SQLRETURN SQLFreeHandle(SQLSMALLINT, SQLHANDLE);
+SQLRETURN SQLSetEnvAttr(SQLHENV, SQLINTEGER, SQLPOINTER, SQLINTEGER);
+SQLRETURN SQLSetConnectAttr(SQLHDBC, SQLINTEGER, SQLPOINTER, SQLINTEGER);
+SQLRETURN SQLGetConnectAttr(SQLHDBC, SQLINTEGER, SQLPOINTER, SQLINTEGER, SQLINTEGER*);
+SQLRETURN SQLConnect(SQLHDBC, SQLCHAR*, SQLSMALLINT, SQLCHAR*, SQLSMALLINT, SQLCHAR*, SQLSMALLINT);
+SQLRETURN SQLDriverConnect(SQLHDBC, SQLHWND, SQLCHAR*, SQLSMALLINT, SQLCHAR*, SQLSMALLINT, SQLSMALLINT*, SQLUSMALLINT);
+SQLRETURN SQLDisconnect(SQLHDBC);
+SQLRETURN SQLEndTran(SQLSMALLINT, SQLHANDLE, SQLSMALLINT);
+SQLRETURN SQLSetStmtAttr(SQLHSTMT, SQLINTEGER, SQLPOINTER, SQLINTEGER);
+SQLRETURN SQLExecDirect(SQLHSTMT, SQLCHAR*, SQLINTEGER);
+SQLRETURN SQLPrepare(SQLHSTMT, SQLCHAR*, SQLINTEGER);
+SQLRETURN SQLBindParameter(SQLHSTMT, SQLUSMALLINT, SQLSMALLINT, SQLSMALLINT, SQLSMALLINT, SQLULEN, SQLSMALLINT, SQLPOINTER, SQLLEN, SQLLEN*);
+SQLRETURN SQLExecute(SQLHSTMT);
+SQLRETURN SQLNumResultCols(SQLHSTMT, SQLSMALLINT*);
+SQLRETURN SQLDescribeCol(SQLHSTMT, SQLUSMALLINT, SQLCHAR*, SQLSMALLINT, SQLSMALLINT*, SQLSMALLINT*, SQLULEN*, SQLSMALLINT*, SQLSMALLINT*);
+SQLRETURN SQLBindCol(SQLHSTMT, SQLUSMALLINT, SQLSMALLINT, SQLPOINTER, SQLLEN, SQLLEN*);
+SQLRETURN SQLFetch(SQLHSTMT);
+SQLRETURN SQLGetData(SQLHSTMT, SQLUSMALLINT, SQLSMALLINT, SQLPOINTER, SQLLEN, SQLLEN*);
+SQLRETURN SQLRowCount(SQLHSTMT, SQLLEN*);
+SQLRETURN SQLCloseCursor(SQLHSTMT);
+SQLRETURN SQLFreeStmt(SQLHSTMT, SQLUSMALLINT);
+SQLRETURN SQLCancel(SQLHSTMT);
+SQLRETURN SQLGetDiagRec(SQLSMALLINT, SQLHANDLE, SQLSMALLINT, SQLCHAR*, SQLINTEGER*, SQLCHAR*, SQLSMALLINT, SQLSMALLINT*);
+
+} // extern "C"
@@ -334,3 +334,105 @@ TEST(ResourceHandleRefactor, StressTest) {
 
     EXPECT_GT(total_acquisitions, 100) << "Should handle many acquisitions under stress";
 }
+
+// Test 7: Maintenance evicts long-idle resources but keeps min_idle ready
+TEST(ResourceHandleRefactor, MaintenanceEvictsIdleAndKeepsMinIdle) {
+    std::atomic<int> id_counter{0};
+    std::atomic<int> destroyed{0};
+
+    auto factory = [&]() {
+        return std::make_unique<Connection>(++id_counter);
+    };
+
+    PoolConfig config;
+    config.initial_size = 4;
+    config.max_size = 6;
+    config.max_idle_time_seconds = 1;
+    config.min_idle = 2;
+    config.maintenance_interval = 20ms;
+
+    ResourcePool<Connection> pool(factory, config, nullptr,
+                                  [&destroyed](Connection&) { ++destroyed; });
+
+    // Evicted down to the floor once idle for over a second
+    auto deadline = std::chrono::steady_clock::now() + 3s;
+    while (pool.getStats().available_count > 2 && std::chrono::steady_clock::now() < deadline) {
+        std::this_thread::sleep_for(10ms);
+    }
+    EXPECT_EQ(pool.getStats().available_count, 2u);
+    EXPECT_EQ(pool.getStats().total_created, 2u);
+    EXPECT_EQ(destroyed, 2);
+
+    // Taking the idle ones makes maintenance pre-create replacements
+    auto a = pool.acquire();
+    auto b = pool.acquire();
+    deadline = std::chrono::steady_clock::now() + 3s;
+    while (pool.getStats().available_count < 2 && std::chrono::steady_clock::now() < deadline) {
+        std::this_thread::sleep_for(10ms);
+    }
+    EXPECT_EQ(pool.getStats().available_count, 2u);
+    EXPECT_EQ(pool.getStats().total_created, 4u);
+    EXPECT_EQ(id_counter, 6);
+}
+
+// Test 8: Maintenance validates idle resources without a caller paying for it
+TEST(ResourceHandleRefactor, MaintenanceValidatesIdle) {
+    std::atomic<int> id_counter{0};
+    std::atomic<int> broken_id{0};
+
+    auto factory = [&]() {
+        return std::make_unique<Connection>(++id_counter);
+    };
+    auto validator = [&broken_id](const Connection& conn) {
+        return conn.id != broken_id;
+    };
+
+    PoolConfig config;
+    config.initial_size = 3;
+    config.max_size = 3;
+    config.validate_idle = true;
+    config.maintenance_interval = 0ms; // Driven manually
+
+    ResourcePool<Connection> pool(factory, config, validator);
+
+    broken_id = 2;
+    pool.runMaintenance();
+    EXPECT_EQ(pool.getStats().available_count, 2u);
+    EXPECT_EQ(pool.getStats().total_created, 2u);
+
+    auto a = pool.acquire();
+    auto b = pool.acquire();
+    EXPECT_NE(a->id, 2);
+    EXPECT_NE(b->id, 2);
+}
+
+// Test 9: Idle validation does not hide expired resources from eviction
+TEST(ResourceHandleRefactor, MaintenanceEvictsAfterIdleValidation) {
+    std::atomic<int> id_counter{0};
+
+    auto factory = [&]() {
+        return std::make_unique<Connection>(++id_counter);
+    };
+    auto validator = [](const Connection&) { return true; };
+
+    PoolConfig config;
+    config.initial_size = 0;
+    config.max_size = 2;
+    config.max_idle_time_seconds = 1;
+    config.validate_idle = true;
+    config.maintenance_interval = 0ms; // Driven manually
+
+    ResourcePool<Connection> pool(factory, config, validator);
+    {
+        auto older = pool.acquire();
+        auto younger = pool.acquire();
+        older.release();
+        std::this_thread::sleep_for(600ms);
+    }
+    pool.runMaintenance(); // Nothing expired yet; validation puts both back
+
+    std::this_thread::sleep_for(600ms);
+    pool.runMaintenance(); // Only the older one is past the limit
+    EXPECT_EQ(pool.getStats().available_count, 1u);
+    EXPECT_EQ(pool.getStats().total_created, 1u);
+}
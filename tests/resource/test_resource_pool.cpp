@@ -0,0 +1,513 @@
+// Unit tests for resource::ResourcePool asynchronous acquisition and PooledRef
+
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <new>
+#include <exception>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+#include "resource/resource_pool.hpp"
+#include "worker/WorkerPool.h"
+
+using namespace std::chrono_literals;
+
+namespace {
+std::atomic<std::size_t> g_allocations{0};
+} // namespace
+
+// Count heap allocations so PooledRef's allocation-free path can be asserted
+void* operator new(std::size_t size) {
+  ++g_allocations;
+  if (void* p = std::malloc(size ? size : 1)) return p;
+  throw std::bad_alloc();
+}
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wmismatched-new-delete" // free() pairs with the malloc() above
+void operator delete(void* p) noexcept { std::free(p); }
+void operator delete(void* p, std::size_t) noexcept { std::free(p); }
+#pragma GCC diagnostic pop
+
+namespace {
+
+struct Resource {
+  int id = 0;
+  bool healthy = true;
+};
+
+using Pool = resource::ResourcePool<Resource>;
+
+std::shared_ptr<Pool> make_pool(std::size_t max_size, std::atomic<int>& created,
+                                Pool::Validator validator = {}) {
+  return Pool::create(max_size, [&created] {
+    auto r = std::make_unique<Resource>();
+    r->id = ++created;
+    return r;
+  }, std::move(validator));
+}
+
+worker::WorkerPool::Options worker_options(std::size_t thread_count) {
+  worker::WorkerPool::Options options;
+  options.thread_count = thread_count;
+  return options;
+}
+
+// Records callback outcomes; wait() blocks the test thread until `n` arrived
+struct Results {
+  std::mutex mtx;
+  std::condition_variable cv;
+  std::vector<Pool::SharedPtr> resources;
+  std::vector<std::exception_ptr> errors;
+  std::vector<std::thread::id> threads;
+
+  Pool::AcquireCallback callback() {
+    return [this](Pool::SharedPtr r, std::exception_ptr e) {
+      std::lock_guard<std::mutex> lk(mtx);
+      resources.push_back(std::move(r));
+      errors.push_back(e);
+      threads.push_back(std::this_thread::get_id());
+      cv.notify_all();
+    };
+  }
+
+  bool wait(std::size_t n) {
+    std::unique_lock<std::mutex> lk(mtx);
+    return cv.wait_for(lk, 2s, [&] { return resources.size() >= n; });
+  }
+};
+
+struct RejectingExecutor {
+  bool post(std::function<void()>) { return false; }
+};
+
+} // namespace
+
+TEST(ResourcePoolAsync, CreatesAndCompletesOnExecutor) {
+  std::atomic<int> created{0};
+  auto pool = make_pool(2, created);
+  worker::WorkerPool workers(worker_options(1));
+  Results results;
+
+  pool->async_acquire(workers.get_executor(), results.callback());
+  ASSERT_TRUE(results.wait(1));
+  ASSERT_NE(results.resources[0], nullptr);
+  EXPECT_EQ(results.errors[0], nullptr);
+  EXPECT_NE(results.threads[0], std::this_thread::get_id());
+  EXPECT_EQ(created, 1);
+}
+
+TEST(ResourcePoolAsync, QueuedWaitersAreServedInOrderOnRelease) {
+  std::atomic<int> created{0};
+  auto pool = make_pool(1, created);
+  worker::WorkerPool workers(worker_options(2));
+  Results results;
+
+  auto held = pool->acquire();
+  Resource* raw = held.get();
+  pool->async_acquire(workers.get_executor(), results.callback());
+  pool->async_acquire(workers.get_executor(), results.callback());
+  EXPECT_EQ(pool->async_waiting(), 2u);
+
+  held.reset();
+  ASSERT_TRUE(results.wait(1));
+  EXPECT_EQ(results.resources[0].get(), raw);
+  EXPECT_EQ(pool->async_waiting(), 1u);
+
+  {
+    std::lock_guard<std::mutex> lk(results.mtx);
+    results.resources[0].reset(); // second waiter gets it next
+  }
+  ASSERT_TRUE(results.wait(2));
+  EXPECT_EQ(results.resources[1].get(), raw);
+  EXPECT_EQ(created, 1);
+}
+
+TEST(ResourcePoolAsync, DeadlineCompletesWithNull) {
+  std::atomic<int> created{0};
+  auto pool = make_pool(1, created);
+  worker::WorkerPool workers(worker_options(1));
+  Results results;
+
+  auto held = pool->acquire();
+  const auto start = Pool::Clock::now();
+  pool->async_acquire(workers.get_executor(), results.callback(), start + 50ms);
+  ASSERT_TRUE(results.wait(1));
+  EXPECT_GE(Pool::Clock::now() - start, 50ms);
+  EXPECT_EQ(results.resources[0], nullptr);
+  EXPECT_EQ(results.errors[0], nullptr);
+  EXPECT_EQ(pool->async_waiting(), 0u);
+
+  // The expired waiter does not take the released resource
+  held.reset();
+  EXPECT_EQ(pool->idle_size(), 1u);
+}
+
+TEST(ResourcePoolAsync, FutureFormReportsResourceAndErrors) {
+  std::atomic<int> created{0};
+  auto pool = make_pool(1, created);
+  worker::WorkerPool workers(worker_options(1));
+
+  auto ok = pool->async_acquire(workers.get_executor());
+  ASSERT_EQ(ok.wait_for(2s), std::future_status::ready);
+  auto conn = ok.get();
+  ASSERT_NE(conn, nullptr);
+
+  auto timed_out = pool->async_acquire(workers.get_executor(), Pool::Clock::now() + 20ms);
+  ASSERT_EQ(timed_out.wait_for(2s), std::future_status::ready);
+  EXPECT_EQ(timed_out.get(), nullptr);
+
+  auto failing = Pool::create(1, []() -> std::unique_ptr<Resource> { throw std::runtime_error("connect failed"); });
+  auto error = failing->async_acquire(workers.get_executor());
+  ASSERT_EQ(error.wait_for(2s), std::future_status::ready);
+  EXPECT_THROW(error.get(), std::runtime_error);
+  EXPECT_EQ(failing->total(), 0u);
+}
+
+TEST(ResourcePoolAsync, InvalidReleaseCreatesReplacementForWaiter) {
+  std::atomic<int> created{0};
+  auto pool = make_pool(1, created, [](const Resource& r) { return r.healthy; });
+  worker::WorkerPool workers(worker_options(1));
+  Results results;
+
+  auto held = pool->acquire();
+  pool->async_acquire(workers.get_executor(), results.callback());
+  held->healthy = false;
+  held.reset();
+  ASSERT_TRUE(results.wait(1));
+  ASSERT_NE(results.resources[0], nullptr);
+  EXPECT_EQ(results.resources[0]->id, 2);
+  EXPECT_EQ(pool->total(), 1u);
+}
+
+TEST(ResourcePoolAsync, ShutdownAndRejectionCompleteWithError) {
+  std::atomic<int> created{0};
+  auto pool = make_pool(1, created);
+  worker::WorkerPool workers(worker_options(1));
+  Results results;
+
+  // A rejecting executor completes on the calling thread and frees the slot
+  pool->async_acquire(RejectingExecutor{}, results.callback());
+  ASSERT_TRUE(results.wait(1));
+  EXPECT_NE(results.errors[0], nullptr);
+  EXPECT_EQ(results.threads[0], std::this_thread::get_id());
+  EXPECT_EQ(pool->total(), 0u);
+
+  auto held = pool->acquire();
+  pool->async_acquire(workers.get_executor(), results.callback(), Pool::Clock::now() + 10s);
+  pool->shutdown();
+  ASSERT_TRUE(results.wait(2));
+  EXPECT_EQ(results.resources[1], nullptr);
+  EXPECT_NE(results.errors[1], nullptr);
+
+  pool->async_acquire(workers.get_executor(), results.callback());
+  ASSERT_TRUE(results.wait(3));
+  EXPECT_NE(results.errors[2], nullptr);
+}
+
+TEST(ResourcePoolRef, AcquireAndReleaseDoNotAllocate) {
+  std::atomic<int> created{0};
+  auto pool = Pool::create(2, [&created] {
+    auto r = std::make_unique<Resource>();
+    r->id = ++created;
+    return r;
+  }, [](const Resource& r) { return r.healthy; }, /*warmup_size=*/2);
+
+  const auto before = g_allocations.load();
+  for (int i = 0; i < 1000; ++i) {
+    auto a = pool->acquire_ref();
+    auto b = pool->try_acquire_ref();
+    ASSERT_TRUE(a && b);
+    EXPECT_FALSE(pool->try_acquire_ref());
+    Pool::Ref moved = std::move(a);
+    EXPECT_FALSE(a);
+    EXPECT_EQ(pool->in_use(), 2u);
+  }
+  EXPECT_EQ(g_allocations.load(), before);
+  EXPECT_EQ(pool->idle_size(), 2u);
+  EXPECT_EQ(created, 2);
+}
+
+TEST(ResourcePoolRef, ShareHandsOwnershipToSharedPtr) {
+  std::atomic<int> created{0};
+  auto pool = make_pool(1, created);
+
+  auto ref = pool->acquire_ref();
+  Resource* raw = ref.get();
+  auto shared = std::move(ref).share();
+  EXPECT_FALSE(ref);
+  ASSERT_EQ(shared.get(), raw);
+  EXPECT_EQ(pool->in_use(), 1u);
+
+  auto copy = shared;
+  shared.reset();
+  EXPECT_EQ(pool->in_use(), 1u);
+  copy.reset();
+  EXPECT_EQ(pool->idle_size(), 1u);
+
+  // Released resources are reused by either handle type
+  EXPECT_EQ(pool->acquire().get(), raw);
+  EXPECT_EQ(pool->acquire_ref_for(10ms).get(), raw);
+}
+
+TEST(ResourcePoolRef, OutlivesThePool) {
+  static std::atomic<int> destroyed{0};
+  struct Tracked {
+    ~Tracked() { ++destroyed; }
+    int value = 42;
+  };
+  destroyed = 0;
+  auto pool = resource::ResourcePool<Tracked>::create(2, [] { return std::make_unique<Tracked>(); });
+  auto held = pool->acquire_ref();
+  pool->acquire_ref().reset(); // one idle resource
+
+  pool.reset(); // shuts down and drops the idle resource
+  EXPECT_EQ(destroyed, 1);
+  EXPECT_EQ(held->value, 42);
+  held.reset();
+  EXPECT_EQ(destroyed, 2);
+}
+
+TEST(ResourcePoolShards, StealsFromOtherShards) {
+  std::atomic<int> created{0};
+  auto pool = Pool::create(4, [&created] {
+    auto r = std::make_unique<Resource>();
+    r->id = ++created;
+    return r;
+  }, {}, /*warmup_size=*/4, /*shards=*/4);
+  ASSERT_EQ(pool->shards(), 4u);
+
+  // Warm-up spread one resource per shard; this thread drains them all
+  std::vector<Pool::Ref> held;
+  for (int i = 0; i < 4; ++i) {
+    held.push_back(pool->try_acquire_ref());
+    ASSERT_TRUE(held.back());
+  }
+  EXPECT_FALSE(pool->try_acquire_ref());
+  EXPECT_EQ(created, 4);
+  EXPECT_EQ(pool->in_use(), 4u);
+  held.clear();
+  EXPECT_EQ(pool->idle_size(), 4u);
+}
+
+TEST(ResourcePoolShards, StaysWithinMaxSizeUnderContention) {
+  std::atomic<int> created{0};
+  auto pool = Pool::create(3, [&created] {
+    auto r = std::make_unique<Resource>();
+    r->id = ++created;
+    return r;
+  }, {}, 0, /*shards=*/4);
+  worker::WorkerPool workers(worker_options(2));
+
+  std::atomic<int> checked_out{0};
+  std::atomic<int> peak{0};
+  auto use = [&](Resource&) {
+    const int now = ++checked_out;
+    int seen = peak.load();
+    while (now > seen && !peak.compare_exchange_weak(seen, now)) {}
+    std::this_thread::yield();
+    --checked_out;
+  };
+
+  std::atomic<int> async_done{0};
+  std::vector<std::thread> threads;
+  for (int t = 0; t < 8; ++t) {
+    threads.emplace_back([&, t] {
+      for (int i = 0; i < 500; ++i) {
+        if (t == 0 && i % 10 == 0) {
+          pool->async_acquire(workers.get_executor(), [&](Pool::SharedPtr r, std::exception_ptr) {
+            if (r) use(*r);
+            ++async_done;
+          });
+        } else if (i % 2) {
+          auto r = pool->acquire_ref();
+          use(*r);
+        } else {
+          auto r = pool->acquire();
+          use(*r);
+        }
+      }
+    });
+  }
+  for (auto& th : threads) th.join();
+  for (const auto until = Pool::Clock::now() + 2s; async_done < 50 && Pool::Clock::now() < until;) {
+    std::this_thread::sleep_for(1ms);
+  }
+  ASSERT_EQ(async_done, 50);
+
+  EXPECT_LE(peak, 3);
+  EXPECT_LE(created, 3);
+  EXPECT_EQ(pool->in_use(), 0u);
+  EXPECT_EQ(pool->idle_size(), pool->total());
+}
+
+TEST(ResourcePoolMaintenance, EvictsExpiredIdleDownToMinIdle) {
+  std::atomic<int> created{0};
+  auto pool = Pool::create(4, [&created] {
+    auto r = std::make_unique<Resource>();
+    r->id = ++created;
+    return r;
+  }, {}, /*warmup_size=*/4, /*shards=*/2);
+  pool->start_maintenance({.interval = 0ms, .max_idle_time = 20ms, .min_idle = 1});
+
+  pool->run_maintenance();
+  EXPECT_EQ(pool->idle_size(), 4u); // not idle long enough yet
+
+  std::this_thread::sleep_for(30ms);
+  pool->acquire_ref().reset(); // refreshes one resource's idle time
+  pool->run_maintenance();
+  EXPECT_EQ(pool->idle_size(), 1u);
+  EXPECT_EQ(pool->total(), 1u);
+
+  EXPECT_THROW(pool->start_maintenance({}), std::logic_error);
+}
+
+TEST(ResourcePoolMaintenance, EvictsExpiredIdleAfterValidationPass) {
+  std::atomic<int> created{0};
+  auto pool = make_pool(2, created, [](const Resource&) { return true; });
+  pool->start_maintenance({.interval = 0ms, .max_idle_time = 200ms, .validate_idle = true});
+  {
+    auto older = pool->acquire_ref();
+    auto younger = pool->acquire_ref();
+    older.reset();
+    std::this_thread::sleep_for(100ms);
+  }
+  pool->run_maintenance(); // nothing expired yet; validation puts both back
+
+  std::this_thread::sleep_for(150ms);
+  pool->run_maintenance(); // only the older one is past the limit
+  EXPECT_EQ(pool->idle_size(), 1u);
+  EXPECT_EQ(pool->total(), 1u);
+}
+
+TEST(ResourcePoolMaintenance, RefillsMinIdleInBackground) {
+  std::atomic<int> created{0};
+  auto pool = make_pool(4, created);
+  pool->start_maintenance({.interval = 5ms, .min_idle = 2});
+
+  for (const auto until = Pool::Clock::now() + 2s; pool->idle_size() < 2 && Pool::Clock::now() < until;) {
+    std::this_thread::sleep_for(1ms);
+  }
+  ASSERT_EQ(pool->idle_size(), 2u);
+
+  // Request threads take the pre-created resources instead of connecting
+  auto a = pool->acquire_ref();
+  auto b = pool->acquire_ref();
+  EXPECT_EQ(created, 2);
+}
+
+TEST(ResourcePoolMaintenance, ValidatesIdleResources) {
+  std::atomic<int> created{0};
+  std::atomic<int> broken{0};
+  auto pool = make_pool(3, created, [&broken](const Resource& r) { return r.id != broken; });
+  {
+    auto a = pool->acquire_ref();
+    auto b = pool->acquire_ref();
+    auto c = pool->acquire_ref();
+  }
+  pool->start_maintenance({.interval = 0ms, .validate_idle = true});
+
+  broken = 2;
+  pool->run_maintenance();
+  EXPECT_EQ(pool->idle_size(), 2u);
+  EXPECT_EQ(pool->total(), 2u);
+  auto a = pool->try_acquire_ref();
+  auto b = pool->try_acquire_ref();
+  ASSERT_TRUE(a && b);
+  EXPECT_NE(a->id, 2);
+  EXPECT_NE(b->id, 2);
+  EXPECT_EQ(created, 3);
+}
+
+// Pool whose validator counts its runs; creation runs it once per resource
+std::shared_ptr<Pool> make_counting_pool(std::size_t max_size, std::atomic<int>& created,
+                                         std::atomic<int>& checks) {
+  return make_pool(max_size, created, [&checks](const Resource& r) {
+    ++checks;
+    return r.healthy;
+  });
+}
+
+TEST(ResourcePoolValidation, DefaultValidatesOnAcquireAndRelease) {
+  std::atomic<int> created{0};
+  std::atomic<int> checks{0};
+  auto pool = make_counting_pool(1, created, checks);
+  pool->acquire_ref().reset();
+  checks = 0;
+
+  auto ref = pool->acquire_ref();
+  EXPECT_EQ(checks, 1);
+  ref.reset();
+  EXPECT_EQ(checks, 2);
+}
+
+TEST(ResourcePoolValidation, IdleThresholdSkipsRecentlyUsedResources) {
+  std::atomic<int> created{0};
+  std::atomic<int> checks{0};
+  auto pool = make_counting_pool(1, created, checks);
+  pool->set_validation_policy({.idle_longer_than = 50ms});
+  pool->acquire_ref().reset();
+  checks = 0;
+
+  pool->acquire_ref().reset();
+  EXPECT_EQ(checks, 0);
+
+  std::this_thread::sleep_for(80ms);
+  auto ref = pool->acquire_ref();
+  EXPECT_EQ(checks, 1);
+  ref.reset();
+  EXPECT_EQ(checks, 1);
+  EXPECT_EQ(created, 1);
+}
+
+TEST(ResourcePoolValidation, EveryNUses) {
+  std::atomic<int> created{0};
+  std::atomic<int> checks{0};
+  auto pool = make_counting_pool(1, created, checks);
+  pool->set_validation_policy({.every_n_uses = 3});
+  pool->acquire_ref().reset();
+  checks = 0;
+
+  for (int i = 0; i < 6; ++i) {
+    pool->acquire_ref().reset();
+  }
+  EXPECT_EQ(checks, 2);
+}
+
+TEST(ResourcePoolValidation, OnErrorOnlyChecksFailedResources) {
+  std::atomic<int> created{0};
+  std::atomic<int> checks{0};
+  auto pool = make_counting_pool(1, created, checks);
+  pool->set_validation_policy({.on_error_only = true});
+  pool->acquire_ref().reset();
+  checks = 0;
+
+  for (int i = 0; i < 3; ++i) {
+    pool->acquire().reset();
+  }
+  EXPECT_EQ(checks, 0);
+
+  // A failure the validator does not confirm keeps the resource
+  auto ref = pool->acquire_ref();
+  ref.mark_failed();
+  ref.reset();
+  EXPECT_EQ(checks, 1);
+  EXPECT_EQ(pool->idle_size(), 1u);
+
+  // A confirmed one drops it
+  auto shared = pool->acquire();
+  shared->healthy = false;
+  Pool::mark_failed(shared);
+  shared.reset();
+  EXPECT_EQ(checks, 2);
+  EXPECT_EQ(pool->total(), 0u);
+
+  pool->acquire_ref().reset();
+  EXPECT_EQ(created, 2);
+}